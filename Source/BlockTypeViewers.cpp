@@ -21,6 +21,10 @@
 #include "ConfigManager/ConfigReader.h"
 #include "Blocks/BlockRegistryReader.h"
 #include "Blocks/Voxel.h"
+#include "Blocks/BlockTextureArray.h"
+#include "World/Sky/DayNightCycle.h"
+#include "Utils/FrameClock.h"
+#include "Utils/ShaderCache.h"
 
 // Callback function for window resize
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -159,13 +163,15 @@ int main() {
     // Set voxel position
     currentVoxel->setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
     
-    // Lighting setup
-    glm::vec3 lightDir(-0.2f, -1.0f, -0.3f);
-    glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
+    // Lighting from the day/night cycle, as in the world viewer. The clock stays
+    // at the configured hour unless moved with the slider.
+    Zenith::DayNightCycle dayNightCycle;
+    dayNightCycle.setTime(config.timeOfDay.startHour);
+    dayNightCycle.setPaused(true);
     
-    // Timing variables
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    // Frame timing, limited to the configured rate when vsync is off
+    Zenith::FrameClock frameClock;
+    frameClock.setFrameLimit(config.performance.vsync ? 0 : config.performance.targetFPS);
     
     // Mouse lock state
     bool mouseLocked = false;
@@ -173,10 +179,9 @@ int main() {
     
     // Main render loop
     while (!glfwWindowShouldClose(window)) {
-        // Calculate delta time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        // Nothing is simulated here, so the ticks are unused
+        frameClock.beginFrame();
+        float deltaTime = frameClock.getFrameSeconds();
         
         // Start the ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -363,6 +368,11 @@ int main() {
             ImGui::EndChild();
         }
         
+        ImGui::Separator();
+        float timeOfDay = dayNightCycle.getTime();
+        if (ImGui::SliderFloat("Time of Day", &timeOfDay, 0.0f, 24.0f, "%.2f h")) {
+            dayNightCycle.setTime(timeOfDay);
+        }
         ImGui::End();
         
         // Clear the screen
@@ -381,18 +391,24 @@ int main() {
         
         // Render the current voxel
         if (currentVoxel) {
-            currentVoxel->render(model, view, projection, lightDir, lightColor, camera.getPosition());
+            const Zenith::SkyLighting& lighting = dayNightCycle.getLighting();
+            currentVoxel->render(model, view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
         }
         
         // Render ImGui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         
-        // Swap buffers and poll events
+        // Hold the frame limit, then swap buffers and poll events
+        frameClock.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
     
+    // Release the shared GL objects while the context is alive
+    Zenith::BlockTextureArray::shared().release();
+    Zenith::ShaderCache::shared().release();
+    
     // Cleanup ImGui
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Zenith {
+
+/**
+ * How leaves are drawn. Fast leaves are solid blocks with the holes filled in, so
+ * the faces between them are culled and they stay in the opaque pass. Fancy leaves
+ * keep their holes, alpha tested in a pass of their own.
+ */
+enum class LeavesMode {
+    FAST,
+    FANCY
+};
+
+/**
+ * Render-side description of a block type, resolved once from the registry
+ * so meshing and drawing never have to look blocks up by name
+ */
+struct BlockMaterial {
+    // BlockTextureArray layer per face, in Voxel face order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+    std::array<uint16_t, 6> faceLayers{};
+
+    // Opaque blocks stop light and hide the faces of their neighbours
+    bool opaque = true;
+    
+    // Non-opaque blocks drawn without holes that still hide neighbouring faces:
+    // fast leaves. Light passes through them as before.
+    bool solid = false;
+    
+    // Alpha tested blocks (fancy leaves) are drawn in their own pass after the
+    // opaque geometry, so the opaque pass has no discard and keeps early depth tests
+    bool cutout = false;
+    
+    // Translucent blocks (glass, water) are blended in a pass after the opaque
+    // geometry, sorted back to front
+    bool translucent = false;
+    
+    // Block light emitted, 0..15 (glowstone, lava, lamps)
+    uint8_t lightEmission = 0;
+    
+    // Blocks without textures (AIR, unknown ids) are never meshed
+    bool visible = true;
+};
+
+} // namespace Zenith
@@ -1,5 +1,6 @@
 #include "BlockRegistryReader.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
@@ -27,6 +28,9 @@ bool BlockRegistryReader::loadRegistry() {
 
         // Clear any existing data
         m_blockTextures.clear();
+        m_transparentBlocks.clear();
+        m_leavesBlocks.clear();
+        m_lightEmission.clear();
 
         // Check if the JSON has a "blocks" array
         if (registry.contains("blocks") && registry["blocks"].is_array()) {
@@ -35,6 +39,18 @@ bool BlockRegistryReader::loadRegistry() {
                 if (blockData.contains("id") && blockData.contains("textures")) {
                     std::string blockId = blockData["id"].get<std::string>();
                     processBlockEntry(blockId, blockData["textures"]);
+
+                    if (blockData.value("transparent", false)) {
+                        m_transparentBlocks.insert(blockId);
+                    }
+                    if (blockData.value("leaves", false)) {
+                        m_leavesBlocks.insert(blockId);
+                    }
+
+                    int light = blockData.value("light", 0);
+                    if (light > 0) {
+                        m_lightEmission[blockId] = std::min(light, 15);
+                    }
                 }
             }
         } else {
@@ -64,6 +80,19 @@ bool BlockRegistryReader::hasBlock(const std::string& blockId) const {
     return m_blockTextures.find(blockId) != m_blockTextures.end();
 }
 
+bool BlockRegistryReader::isTransparent(const std::string& blockId) const {
+    return m_transparentBlocks.find(blockId) != m_transparentBlocks.end();
+}
+
+bool BlockRegistryReader::isLeaves(const std::string& blockId) const {
+    return m_leavesBlocks.find(blockId) != m_leavesBlocks.end();
+}
+
+int BlockRegistryReader::getLightEmission(const std::string& blockId) const {
+    auto it = m_lightEmission.find(blockId);
+    return it != m_lightEmission.end() ? it->second : 0;
+}
+
 size_t BlockRegistryReader::getBlockCount() const {
     return m_blockTextures.size();
 }
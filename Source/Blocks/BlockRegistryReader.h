@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <array>
 #include <memory>
 #include <functional>
@@ -51,6 +52,28 @@ public:
      */
     bool hasBlock(const std::string& blockId) const;
 
+    /**
+     * Checks if a block lets light and sight through (glass, leaves, water...)
+     * @param blockId The ID to check
+     * @return true if the block is flagged transparent in the registry, false otherwise
+     */
+    bool isTransparent(const std::string& blockId) const;
+
+    /**
+     * Checks if a block is foliage, drawn alpha tested or solid depending on the
+     * leaves mode instead of blended
+     * @param blockId The ID to check
+     * @return true if the block is flagged "leaves" in the registry, false otherwise
+     */
+    bool isLeaves(const std::string& blockId) const;
+
+    /**
+     * Gets the block light a block emits
+     * @param blockId The ID to check
+     * @return The "light" level from the registry, 0..15, 0 for blocks without one
+     */
+    int getLightEmission(const std::string& blockId) const;
+
     /**
      * Gets the number of blocks in the registry
      * @return The number of blocks
@@ -86,6 +109,9 @@ private:
     std::string buildTexturePath(const std::string& texturePath) const;
 
     std::unordered_map<std::string, BlockTextures> m_blockTextures;
+    std::unordered_set<std::string> m_transparentBlocks;
+    std::unordered_set<std::string> m_leavesBlocks;
+    std::unordered_map<std::string, int> m_lightEmission;
     std::string m_assetsPath;
     bool m_isLoaded;
 };
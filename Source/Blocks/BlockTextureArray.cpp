@@ -0,0 +1,159 @@
+#include "BlockTextureArray.h"
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <iostream>
+
+namespace Zenith {
+
+BlockTextureArray& BlockTextureArray::shared() {
+    static BlockTextureArray textureArray;
+    return textureArray;
+}
+
+BlockTextureArray::BlockTextureArray()
+    : m_layerCount(0), m_uploadedLayers(0), m_texture(0)
+{
+    // Layer 0 is the placeholder for missing textures
+    unsigned char checker[4 * 4];
+    for (int i = 0; i < 4; i++) {
+        bool magenta = (i == 0 || i == 3);
+        checker[i * 4 + 0] = magenta ? 255 : 0;
+        checker[i * 4 + 1] = 0;
+        checker[i * 4 + 2] = magenta ? 255 : 0;
+        checker[i * 4 + 3] = 255;
+    }
+    addLayer(checker, 2, 2, 4);
+}
+
+uint16_t BlockTextureArray::getLayer(const std::string& path, bool solid) {
+    // Solid variants are cached under their own key
+    std::string key = solid ? path + "#solid" : path;
+    auto it = m_layers.find(key);
+    if (it != m_layers.end()) {
+        return it->second;
+    }
+
+    int width, height, components;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &components, 0);
+
+    // Failed loads are cached too so a missing file is only reported once
+    uint16_t layer = MISSING_LAYER;
+    if (!data) {
+        std::cerr << "Texture failed to load: " << path << std::endl;
+    } else if (components < 1 || components > 4) {
+        std::cerr << "Unsupported texture format: " << path << std::endl;
+    } else if (m_layerCount >= 0xFFFF) {
+        std::cerr << "Block texture array is full, can't add: " << path << std::endl;
+    } else {
+        // Animation strips are a column of square frames, only the first is used
+        int frameHeight = (height > width && height % width == 0) ? width : height;
+        layer = addLayer(data, width, frameHeight, components);
+        if (solid) {
+            fillTransparentTexels(layer);
+        }
+    }
+
+    if (data) {
+        stbi_image_free(data);
+    }
+
+    m_layers[key] = layer;
+    return layer;
+}
+
+void BlockTextureArray::fillTransparentTexels(uint16_t layer) {
+    size_t texels = static_cast<size_t>(LAYER_SIZE) * LAYER_SIZE;
+    unsigned char* pixels = &m_pixels[layer * texels * 4];
+
+    // Holes take the average of the covered texels, darkened like the inside of a bush
+    unsigned int sum[3] = { 0, 0, 0 };
+    unsigned int covered = 0;
+    for (size_t texel = 0; texel < texels; texel++) {
+        const unsigned char* pixel = pixels + texel * 4;
+        if (pixel[3] >= 128) {
+            sum[0] += pixel[0];
+            sum[1] += pixel[1];
+            sum[2] += pixel[2];
+            covered++;
+        }
+    }
+
+    unsigned char fill[3] = { 0, 0, 0 };
+    for (int channel = 0; channel < 3 && covered > 0; channel++) {
+        fill[channel] = static_cast<unsigned char>(sum[channel] / covered / 2);
+    }
+
+    for (size_t texel = 0; texel < texels; texel++) {
+        unsigned char* pixel = pixels + texel * 4;
+        if (pixel[3] < 128) {
+            pixel[0] = fill[0];
+            pixel[1] = fill[1];
+            pixel[2] = fill[2];
+        }
+        pixel[3] = 255;
+    }
+}
+
+uint16_t BlockTextureArray::addLayer(const unsigned char* pixels, int width, int height, int components) {
+    size_t layerBytes = static_cast<size_t>(LAYER_SIZE) * LAYER_SIZE * 4;
+    size_t offset = m_pixels.size();
+    m_pixels.resize(offset + layerBytes);
+
+    // Nearest neighbour keeps the pixel art crisp (16x16 sources scale by exactly 2)
+    for (int y = 0; y < LAYER_SIZE; y++) {
+        int sourceY = y * height / LAYER_SIZE;
+        for (int x = 0; x < LAYER_SIZE; x++) {
+            int sourceX = x * width / LAYER_SIZE;
+            const unsigned char* source = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * components;
+            unsigned char* target = &m_pixels[offset + (static_cast<size_t>(y) * LAYER_SIZE + x) * 4];
+
+            if (components < 3) {
+                // Grey or grey + alpha
+                target[0] = target[1] = target[2] = source[0];
+                target[3] = components == 2 ? source[1] : 255;
+            } else {
+                target[0] = source[0];
+                target[1] = source[1];
+                target[2] = source[2];
+                target[3] = components == 4 ? source[3] : 255;
+            }
+        }
+    }
+
+    return static_cast<uint16_t>(m_layerCount++);
+}
+
+unsigned int BlockTextureArray::getTexture() {
+    if (m_uploadedLayers == m_layerCount) {
+        return m_texture;
+    }
+
+    if (m_texture == 0) {
+        glGenTextures(1, &m_texture);
+    }
+
+    // Layers are only ever added, re-specifying the whole array keeps it simple
+    // and happens a handful of times while a world loads
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, LAYER_SIZE, LAYER_SIZE, static_cast<GLsizei>(m_layerCount),
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    m_uploadedLayers = m_layerCount;
+    return m_texture;
+}
+
+void BlockTextureArray::release() {
+    if (m_texture != 0) {
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
+    m_uploadedLayers = 0;
+}
+
+} // namespace Zenith
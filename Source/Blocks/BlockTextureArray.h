@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenith {
+
+/**
+ * All block face textures in one GL_TEXTURE_2D_ARRAY, so a chunk can be drawn
+ * with a single texture binding and each vertex just carries a layer index.
+ * Images are resampled to LAYER_SIZE x LAYER_SIZE; animated strips keep their
+ * first frame.
+ */
+class BlockTextureArray {
+public:
+    static constexpr int LAYER_SIZE = 32;
+
+    // Layer used for textures that failed to load (magenta/black checker)
+    static constexpr uint16_t MISSING_LAYER = 0;
+
+    /**
+     * Shared array used by every chunk mesh
+     */
+    static BlockTextureArray& shared();
+
+    /**
+     * Gets the layer of an image file, loading it on first use
+     * @param path Full path of the image
+     * @param solid Fill the transparent texels with the image's darkened average
+     *              colour, for leaves drawn without holes (a separate layer)
+     * @return The layer index, MISSING_LAYER if the image can't be loaded
+     */
+    uint16_t getLayer(const std::string& path, bool solid = false);
+
+    /**
+     * Gets the GL texture, uploading any layers added since the last call.
+     * Needs a current GL context.
+     * @return The texture name, 0 if nothing was loaded yet
+     */
+    unsigned int getTexture();
+
+    size_t getLayerCount() const { return m_layerCount; }
+
+    /**
+     * Deletes the GL texture, must be called while the context is alive
+     */
+    void release();
+
+private:
+    BlockTextureArray();
+
+    // Append a LAYER_SIZE^2 RGBA image resampled from the source pixels
+    uint16_t addLayer(const unsigned char* pixels, int width, int height, int components);
+
+    // Make every texel of a layer fully opaque, see getLayer()
+    void fillTransparentTexels(uint16_t layer);
+
+    std::unordered_map<std::string, uint16_t> m_layers;
+    std::vector<unsigned char> m_pixels;    // RGBA8, all layers back to back
+    size_t m_layerCount;
+    size_t m_uploadedLayers;
+    unsigned int m_texture;
+};
+
+} // namespace Zenith
@@ -0,0 +1,87 @@
+#include "Lightmap.h"
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Zenith {
+
+Lightmap& Lightmap::shared() {
+    static Lightmap lightmap;
+    return lightmap;
+}
+
+Lightmap::Lightmap()
+    : m_texture(0), m_loadAttempted(false), m_sunBrightness(1.0f)
+{
+}
+
+unsigned int Lightmap::getTexture() {
+    if (m_loadAttempted) {
+        return m_texture;
+    }
+    m_loadAttempted = true;
+
+    std::string path = std::string(ASSETS_DIR) + "/minecraft/mcpatcher/lightmap/world0.png";
+    int width, height, components;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &components, 3);
+
+    std::vector<unsigned char> fallback;
+    if (!data || height != 32) {
+        std::cerr << "Lightmap failed to load, using a grey ramp: " << path << std::endl;
+        if (data) {
+            stbi_image_free(data);
+            data = nullptr;
+        }
+
+        // One column: light level straight to brightness, block light a little warmer
+        width = 1;
+        height = 32;
+        fallback.resize(32 * 3);
+        for (int level = 0; level < 16; level++) {
+            unsigned char value = static_cast<unsigned char>(level * 17);
+            unsigned char* sky = &fallback[level * 3];
+            unsigned char* block = &fallback[(16 + level) * 3];
+            sky[0] = sky[1] = sky[2] = value;
+            block[0] = value;
+            block[1] = static_cast<unsigned char>(value * 0.8f);
+            block[2] = static_cast<unsigned char>(value * 0.5f);
+        }
+    }
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE,
+                 data ? data : fallback.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Levels are whole rows, only the time of day is blended between columns
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (data) {
+        stbi_image_free(data);
+    }
+    return m_texture;
+}
+
+void Lightmap::bind(unsigned int program, int unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, getTexture());
+    glUniform1i(glGetUniformLocation(program, "lightmap"), unit);
+    glUniform1f(glGetUniformLocation(program, "sunBrightness"), m_sunBrightness);
+}
+
+void Lightmap::release() {
+    if (m_texture != 0) {
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
+    m_loadAttempted = false;
+}
+
+} // namespace Zenith
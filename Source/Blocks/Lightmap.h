@@ -0,0 +1,50 @@
+#pragma once
+
+namespace Zenith {
+
+/**
+ * MCPatcher style lightmap turning the sky and block light baked into chunk
+ * vertices into colours. The image is 32 rows tall: rows 0-15 are the sky light
+ * levels, with columns going from night (left) to full day (right), and rows
+ * 16-31 the block light levels (columns are torch flicker, the middle is used).
+ */
+class Lightmap {
+public:
+    /**
+     * Shared lightmap used by every chunk shader
+     */
+    static Lightmap& shared();
+
+    /**
+     * Gets the GL texture, loading Assets/minecraft/mcpatcher/lightmap/world0.png on
+     * first use. A plain grey ramp is used if the image can't be loaded.
+     * Needs a current GL context.
+     */
+    unsigned int getTexture();
+
+    /**
+     * How far the sky rows are towards full day, 0 (night) .. 1 (noon)
+     */
+    void setSunBrightness(float brightness) { m_sunBrightness = brightness; }
+    float getSunBrightness() const { return m_sunBrightness; }
+
+    /**
+     * Bind the texture to a texture unit and set the "lightmap" and
+     * "sunBrightness" uniforms of the program in use
+     */
+    void bind(unsigned int program, int unit);
+
+    /**
+     * Deletes the GL texture, must be called while the context is alive
+     */
+    void release();
+
+private:
+    Lightmap();
+
+    unsigned int m_texture;
+    bool m_loadAttempted;
+    float m_sunBrightness;
+};
+
+} // namespace Zenith
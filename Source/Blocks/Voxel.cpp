@@ -1,4 +1,6 @@
 #include "Voxel.h"
+#include "BlockTextureArray.h"
+#include "../Utils/ShaderCache.h"
 #include "../Utils/ShaderUtils.h"
 #include <iostream>
 #define STB_IMAGE_IMPLEMENTATION
@@ -13,12 +15,8 @@ Voxel::Voxel()
     , m_VAO(0)
     , m_VBO(0)
     , m_EBO(0)
-    , m_shaderProgramID(0)
 {
-    // Initialize texture IDs to 0
-    for (auto& texID : m_textureIDs) {
-        texID = 0;
-    }
+    m_faceLayers.fill(BlockTextureArray::MISSING_LAYER);
 }
 
 Voxel::~Voxel() {
@@ -34,11 +32,6 @@ Voxel::~Voxel() {
         m_VAO = 0;
         m_VBO = 0;
         m_EBO = 0;
-        m_shaderProgramID = 0;
-        
-        for (auto& texID : m_textureIDs) {
-            texID = 0;
-        }
     }
 }
 
@@ -69,17 +62,9 @@ bool Voxel::loadTextures(const std::string& topPath,
     m_texturePaths[LEFT] = leftPath;
     m_texturePaths[RIGHT] = rightPath;
     
-    // Load the shader program if not already loaded
-    if (m_shaderProgramID == 0) {
-        m_shaderProgramID = ShaderUtils::createShaderProgram(
-            std::string(SHADER_DIR) + "/voxel_vertex.glsl",
-            std::string(SHADER_DIR) + "/voxel_fragment.glsl"
-        );
-        
-        if (m_shaderProgramID == 0) {
-            std::cerr << "Failed to load voxel shaders" << std::endl;
-            return false;
-        }
+    if (getShaderProgram() == 0) {
+        std::cerr << "Failed to load voxel shaders" << std::endl;
+        return false;
     }
     
     // Initialize the voxel if not already initialized
@@ -87,17 +72,15 @@ bool Voxel::loadTextures(const std::string& topPath,
         initialize();
     }
     
-    // Load each texture
-    m_textureIDs[TOP] = loadTextureFromFile(topPath);
-    m_textureIDs[BOTTOM] = loadTextureFromFile(bottomPath);
-    m_textureIDs[FRONT] = loadTextureFromFile(frontPath);
-    m_textureIDs[BACK] = loadTextureFromFile(backPath);
-    m_textureIDs[LEFT] = loadTextureFromFile(leftPath);
-    m_textureIDs[RIGHT] = loadTextureFromFile(rightPath);
+    // Load each texture, images already used by another voxel or a chunk are shared
+    BlockTextureArray& textures = BlockTextureArray::shared();
+    for (int face = 0; face < 6; face++) {
+        m_faceLayers[face] = textures.getLayer(m_texturePaths[face]);
+    }
     
     // Check if all textures loaded successfully
-    for (auto texID : m_textureIDs) {
-        if (texID == 0) {
+    for (uint16_t layer : m_faceLayers) {
+        if (layer == BlockTextureArray::MISSING_LAYER) {
             std::cerr << "Failed to load one or more voxel textures" << std::endl;
             return false;
         }
@@ -217,45 +200,12 @@ void Voxel::setupBuffers() {
     glBindVertexArray(0);
 }
 
-unsigned int Voxel::loadTextureFromFile(const std::string& path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        else {
-            std::cerr << "Unsupported texture format: " << path << std::endl;
-            stbi_image_free(data);
-            glDeleteTextures(1, &textureID);
-            return 0;
-        }
-        
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        stbi_image_free(data);
-        return textureID;
-    } else {
-        std::cerr << "Texture failed to load: " << path << std::endl;
-        stbi_image_free(data);
-        glDeleteTextures(1, &textureID);
-        return 0;
-    }
+unsigned int Voxel::getShaderProgram() {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + "/voxel_vertex.glsl",
+        std::string(SHADER_DIR) + "/voxel_fragment.glsl",
+        ShaderUtils::TEXTURE_ARRAY | ShaderUtils::SPECULAR | ShaderUtils::ALPHA_TEST
+    );
 }
 
 void Voxel::setPosition(const glm::vec3& position) {
@@ -269,32 +219,39 @@ void Voxel::render(const glm::mat4& model, const glm::mat4& view, const glm::mat
         return;
     }
     
+    unsigned int program = getShaderProgram();
+    unsigned int textureArray = BlockTextureArray::shared().getTexture();
+    if (program == 0 || textureArray == 0) {
+        return;
+    }
+    
     // Use the shader program
-    glUseProgram(m_shaderProgramID);
+    glUseProgram(program);
     
     // Apply position transformation
     glm::mat4 modelMatrix = glm::translate(model, m_position);
     
     // Set uniforms
-    glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramID, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
-    glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramID, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform3fv(glGetUniformLocation(m_shaderProgramID, "lightDir"), 1, glm::value_ptr(lightDir));
-    glUniform3fv(glGetUniformLocation(m_shaderProgramID, "lightColor"), 1, glm::value_ptr(lightColor));
-    glUniform3fv(glGetUniformLocation(m_shaderProgramID, "viewPos"), 1, glm::value_ptr(viewPos));
-    glUniform1f(glGetUniformLocation(m_shaderProgramID, "ambientStrength"), 0.3f);
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform3fv(glGetUniformLocation(program, "lightDir"), 1, glm::value_ptr(lightDir));
+    glUniform3fv(glGetUniformLocation(program, "lightColor"), 1, glm::value_ptr(lightColor));
+    glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, glm::value_ptr(viewPos));
+    glUniform1f(glGetUniformLocation(program, "ambientStrength"), 0.3f);
     
     // Bind VAO
     glBindVertexArray(m_VAO);
     
-    // Fixed approach: Activate all textures at once
+    // One texture for every face, the shader picks each face's layer
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+    float faceLayers[6];
     for (int i = 0; i < 6; i++) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, m_textureIDs[i]);
-        // Set uniform for each texture sampler
-        std::string uniformName = "textureFace" + std::to_string(i);
-        glUniform1i(glGetUniformLocation(m_shaderProgramID, uniformName.c_str()), i);
+        faceLayers[i] = static_cast<float>(m_faceLayers[i]);
     }
+    glUniform1fv(glGetUniformLocation(program, "faceLayers"), 6, faceLayers);
     
     // Draw all faces at once
     glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <array>
 #include <vector>
@@ -47,15 +48,13 @@ private:
     // Setup vertex and index buffers
     void setupBuffers();
 
-    // Load a texture from file
-    unsigned int loadTextureFromFile(const std::string& path);
+    // Program shared by every voxel: the TEXTURE_ARRAY permutation, which picks
+    // the face's layer in the vertex shader instead of branching per fragment
+    static unsigned int getShaderProgram();
 
 private:
-    // Texture IDs for each face
-    std::array<unsigned int, 6> m_textureIDs;
-    
-    // Shader program ID
-    unsigned int m_shaderProgramID;
+    // Layer in the BlockTextureArray for each face
+    std::array<uint16_t, 6> m_faceLayers;
     
     // Buffer IDs
     unsigned int m_VAO, m_VBO, m_EBO;
@@ -23,6 +23,7 @@ public:
     float getYaw() const { return yaw; }
     float getPitch() const { return pitch; }
     float getZoom() const { return zoom; }
+    float getMovementSpeed() const { return movementSpeed; }
     
     // Setters
     void setPosition(const glm::vec3& pos) { position = pos; }
@@ -31,6 +32,7 @@ public:
     void setYaw(float y) { yaw = y; updateCameraVectors(); }
     void setPitch(float p) { pitch = p; updateCameraVectors(); }
     void setZoom(float z) { zoom = z; }
+    void setMovementSpeed(float speed) { movementSpeed = speed; }
 
 private:
     // Camera attributes
@@ -0,0 +1,254 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <cmath>
+#include "Blocks/BlockRegistryReader.h"
+#include "Utils/Random.h"
+#include "World/Terrain/TerrainModel.h"
+
+// Compares the classic vertex buffer path with vertex pulling from face records on
+// the same dense terrain: bytes uploaded and time to mesh every chunk, GPU memory
+// held by the meshes, and the average frame time of a fixed camera orbit. Then
+// times single block edits, remesh and relight included, on a 256 x 64 x 256 world.
+
+// Width, height and depth of the world the single edits are timed on
+const int kEditWorldSize[3] = { 256, 64, 256 };
+
+// A single edit should be remeshed and relit well within a frame
+const double kEditTargetMilliseconds = 1.0;
+
+struct PathResult {
+    double meshMilliseconds = 0.0;
+    size_t uploadedBytes = 0;
+    size_t meshBytes = 0;
+    size_t triangles = 0;
+    size_t drawCalls = 0;
+    double frameMilliseconds = 0.0;
+};
+
+PathResult runPath(Zenith::TerrainModel& terrain, Zenith::ChunkMeshLayout layout, GLFWwindow* window,
+                   int width, int height, int frames) {
+    PathResult result;
+
+    // Switching layout marks every chunk dirty, the rebuild is the full upload
+    terrain.setMeshLayout(layout);
+    terrain.rebuildDirtyChunks();
+    glFinish();
+
+    const Zenith::ChunkRebuildStats& rebuildStats = terrain.getLastRebuildStats();
+    result.meshMilliseconds = rebuildStats.milliseconds;
+    result.uploadedBytes = rebuildStats.uploadedBytes;
+
+    int chunksX, chunksY, chunksZ;
+    terrain.getChunkGridSize(chunksX, chunksY, chunksZ);
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cz = 0; cz < chunksZ; cz++) {
+            for (int cx = 0; cx < chunksX; cx++) {
+                result.meshBytes += terrain.getChunk(cx, cy, cz).getMesh().getMemoryBytes();
+            }
+        }
+    }
+
+    int worldWidth, worldHeight, worldDepth;
+    terrain.getDimensions(worldWidth, worldHeight, worldDepth);
+    glm::vec3 center(worldWidth * 0.5f, worldHeight * 0.4f, worldDepth * 0.5f);
+    float radius = worldWidth * 0.6f;
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), static_cast<float>(width) / height, 0.1f, 1000.0f);
+    glm::vec3 lightDir(-0.2f, -1.0f, -0.3f);
+    glm::vec3 lightColor(1.0f);
+
+    // One warm-up frame so shader and texture uploads aren't timed
+    for (int frame = -1; frame < frames; frame++) {
+        float angle = 6.2831853f * std::max(frame, 0) / frames;
+        glm::vec3 eye = center + glm::vec3(std::cos(angle) * radius, worldHeight * 0.6f, std::sin(angle) * radius);
+        glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        auto start = std::chrono::steady_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        terrain.render(view, projection, lightDir, lightColor, eye);
+        glFinish();
+        auto end = std::chrono::steady_clock::now();
+
+        if (frame >= 0) {
+            result.frameMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+            result.triangles = terrain.getLastRenderStats().triangles;
+            result.drawCalls = terrain.getLastRenderStats().drawCalls;
+        }
+        Zenith::ChunkBufferPool::shared().endFrame();
+        glfwSwapBuffers(window);
+    }
+    result.frameMilliseconds /= frames;
+
+    return result;
+}
+
+struct EditResult {
+    size_t edits = 0;
+    double averageMilliseconds = 0.0;
+    double worstMilliseconds = 0.0;
+    double averageChunks = 0.0;     // Chunks remeshed per edit
+};
+
+// Remove a surface block and put it back, `positions` times at random columns,
+// timing each setBlock through rebuildDirtyChunks() and the upload finishing
+EditResult runSingleEdits(const Zenith::BlockRegistryReader& blockRegistry, uint64_t seed,
+                          const Zenith::TerrainSettings& settings, int positions) {
+    EditResult result;
+
+    Zenith::TerrainModel terrain(kEditWorldSize[0], kEditWorldSize[1], kEditWorldSize[2]);
+    terrain.generateTerrain(seed, settings);
+    terrain.createVoxelObjects(blockRegistry);
+    glFinish();
+
+    Zenith::PhiloxRng rng(seed, 1);
+    for (int position = 0; position < positions; position++) {
+        int x = rng.uniformInt(0, kEditWorldSize[0] - 1);
+        int z = rng.uniformInt(0, kEditWorldSize[2] - 1);
+        int y = kEditWorldSize[1] - 1;
+        while (y > 0 && terrain.getBlockType(x, y, z).empty()) {
+            y--;
+        }
+        std::string blockType = terrain.getBlockType(x, y, z);
+        if (blockType.empty()) {
+            continue;
+        }
+
+        for (int step = 0; step < 2; step++) {
+            auto start = std::chrono::steady_clock::now();
+            if (step == 0) {
+                terrain.removeVoxel(x, y, z);
+            } else {
+                terrain.addVoxel(x, y, z, blockType);
+            }
+            terrain.rebuildDirtyChunks();
+            glFinish();
+            auto end = std::chrono::steady_clock::now();
+
+            double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+            result.edits++;
+            result.averageMilliseconds += milliseconds;
+            result.worstMilliseconds = std::max(result.worstMilliseconds, milliseconds);
+            result.averageChunks += terrain.getLastRebuildStats().chunksRebuilt;
+            Zenith::ChunkBufferPool::shared().endFrame();
+        }
+    }
+
+    if (result.edits > 0) {
+        result.averageMilliseconds /= result.edits;
+        result.averageChunks /= result.edits;
+    }
+    return result;
+}
+
+void printResult(const char* label, const PathResult& result) {
+    std::cout << "  " << std::left << std::setw(16) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << result.uploadedBytes / (1024.0 * 1024.0) << " MB"
+              << std::setw(10) << result.meshBytes / (1024.0 * 1024.0) << " MB"
+              << std::setw(11) << result.meshMilliseconds << " ms"
+              << std::setw(11) << result.frameMilliseconds << " ms"
+              << std::setw(12) << result.triangles
+              << std::setw(7) << result.drawCalls << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::stoi(argv[1]) : 256;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 200;
+    uint64_t seed = argc > 3 ? std::stoull(argv[3]) : 1337;
+    const int width = 1280;
+    const int height = 720;
+
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+
+    // Vertex pulling needs shader storage buffers
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(width, height, "Chunk Render Benchmark", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Failed to create an OpenGL 4.3 context" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    glViewport(0, 0, width, height);
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.5f, 0.7f, 0.9f, 1.0f);
+
+    Zenith::BlockRegistryReader blockRegistry;
+    if (!blockRegistry.loadRegistry()) {
+        std::cerr << "Failed to load block registry" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    std::cout << "Zenith Chunk Render Benchmark" << std::endl;
+    std::cout << "=============================" << std::endl;
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+    // Mountains give the most exposed faces per chunk
+    Zenith::TerrainSettings settings;
+    settings.defaultBiome = Zenith::BiomeType::MOUNTAINS;
+    settings.forceBiome = true;
+
+    Zenith::TerrainModel terrain(size, 128, size);
+    terrain.generateTerrain(seed, settings);
+    terrain.createVoxelObjects(blockRegistry);
+    std::cout << "Terrain: " << size << " x 128 x " << size << ", " << terrain.getVoxelCount()
+              << " blocks, seed " << seed << ", " << frames << " frames" << std::endl << std::endl;
+
+    std::cout << "  " << std::left << std::setw(16) << "Path" << std::right
+              << std::setw(13) << "Uploaded" << std::setw(13) << "Memory"
+              << std::setw(14) << "Mesh time" << std::setw(14) << "Frame time"
+              << std::setw(12) << "Triangles" << std::setw(7) << "Draws" << std::endl;
+
+    PathResult classic = runPath(terrain, Zenith::ChunkMeshLayout::QUAD_VERTICES, window, width, height, frames);
+    printResult("Vertex buffers", classic);
+
+    if (Zenith::ChunkMesh::isFacePullingSupported()) {
+        PathResult pulling = runPath(terrain, Zenith::ChunkMeshLayout::FACE_RECORDS, window, width, height, frames);
+        printResult("Vertex pulling", pulling);
+
+        std::cout << std::endl << std::setprecision(2)
+                  << "Vertex pulling uses " << static_cast<double>(classic.meshBytes) / std::max<size_t>(pulling.meshBytes, 1)
+                  << "x less mesh memory, frame time ratio "
+                  << pulling.frameMilliseconds / std::max(classic.frameMilliseconds, 1e-6) << std::endl;
+    } else {
+        std::cout << "  Vertex pulling not supported by this context" << std::endl;
+    }
+
+    // The vertex buffer path also keeps one shared quad index buffer
+    std::cout << "Shared quad index buffer: "
+              << Zenith::CHUNK_VOLUME * 6 * 6 * sizeof(unsigned int) / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    EditResult edits = runSingleEdits(blockRegistry, seed, settings, 50);
+    std::cout << std::endl << "Single block edits on " << kEditWorldSize[0] << " x " << kEditWorldSize[1] << " x "
+              << kEditWorldSize[2] << ", remesh and relight: " << std::setprecision(3)
+              << edits.averageMilliseconds << " ms avg, " << edits.worstMilliseconds << " ms worst, "
+              << std::setprecision(1) << edits.averageChunks << " chunks per edit over " << edits.edits
+              << " edits (target: under " << kEditTargetMilliseconds << " ms, "
+              << (edits.edits > 0 && edits.averageMilliseconds < kEditTargetMilliseconds ? "PASS" : "FAIL") << ")"
+              << std::endl;
+
+    glfwTerminate();
+    return 0;
+}
@@ -35,6 +35,7 @@ Config loadConfig(const std::string& filename) {
     config.performance.numSamples = j["performance"]["numSamples"];
     config.performance.vsync = j["performance"]["vsync"];
     config.performance.targetFPS = j["performance"]["targetFPS"];
+    config.performance.quality = j["performance"].value("quality", std::string("fancy"));
     
     // Parse world configuration if it exists
     if (j.contains("world")) {
@@ -48,6 +49,27 @@ Config loadConfig(const std::string& filename) {
         config.world.forceBiome = false;
     }
     
+    // Parse shadow configuration if it exists
+    if (j.contains("shadows")) {
+        config.shadows.enabled = j["shadows"]["enabled"];
+        config.shadows.resolution = j["shadows"]["resolution"];
+        config.shadows.cascades = j["shadows"].value("cascades", 4);
+    } else {
+        config.shadows.enabled = true;
+        config.shadows.resolution = 2048;
+        config.shadows.cascades = 4;
+    }
+    
+    if (j.contains("timeOfDay")) {
+        config.timeOfDay.startHour = j["timeOfDay"]["startHour"];
+        config.timeOfDay.dayLength = j["timeOfDay"]["dayLength"];
+        config.timeOfDay.shadowThreshold = j["timeOfDay"].value("shadowThreshold", 0.5f);
+    } else {
+        config.timeOfDay.startHour = 10.0f;
+        config.timeOfDay.dayLength = 600.0f;
+        config.timeOfDay.shadowThreshold = 0.5f;
+    }
+    
     config.voxelScale = j["voxelScale"];
     config.skyname = j["skyname"];
 
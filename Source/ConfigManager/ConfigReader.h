@@ -30,6 +30,7 @@ struct PerformanceConfig {
     int numSamples;
     bool vsync;
     int targetFPS;
+    std::string quality;    // Preset, "fast" or "fancy"
 };
 
 struct GridConfig {
@@ -49,6 +50,18 @@ struct WorldConfig {
     bool forceBiome;
 };
 
+struct ShadowConfig {
+    bool enabled;
+    int resolution;     // Shadow map width and height in texels, per cascade
+    int cascades;       // Shadow maps covering successive slices of the view, 1-4
+};
+
+struct TimeOfDayConfig {
+    float startHour;            // 0-24, 12 is noon
+    float dayLength;            // Real seconds per day
+    float shadowThreshold;      // Degrees the sun moves before the shadows are re-rendered
+};
+
 struct Config {
     WindowConfig window;
     TextureAtlasConfig textureAtlas;
@@ -59,6 +72,8 @@ struct Config {
     FullscreenConfig fullscreen;
     std::string skyname;
     WorldConfig world;
+    ShadowConfig shadows;
+    TimeOfDayConfig timeOfDay;
 };
 
 // Declaration only
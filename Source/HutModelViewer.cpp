@@ -21,7 +21,11 @@
 #include "GameControls/MouseHandler.h"
 #include "ConfigManager/ConfigReader.h"
 #include "Blocks/BlockRegistryReader.h"
+#include "Blocks/Lightmap.h"
 #include "World/Models/HutModel.h"
+#include "World/Chunks/ChunkBufferPool.h"
+#include "World/Sky/DayNightCycle.h"
+#include "Utils/FrameClock.h"
 
 // Callback function for window resize
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -117,17 +121,19 @@ int main() {
         "Basic Hut", "Round Hut", "Longhouse", "Tiered Hut"
     };
     
-    // Lighting setup
-    glm::vec3 lightDir(-0.2f, -1.0f, -0.3f);
-    glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
+    // Lighting from the day/night cycle, as in the world viewer. The clock stays
+    // at the configured hour unless moved with the slider.
+    Zenith::DayNightCycle dayNightCycle;
+    dayNightCycle.setTime(config.timeOfDay.startHour);
+    dayNightCycle.setPaused(true);
     
     // Random seed for hut generation
     unsigned int seed = 0;
     bool useCustomSeed = false;
     
-    // Timing variables
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    // Frame timing, limited to the configured rate when vsync is off
+    Zenith::FrameClock frameClock;
+    frameClock.setFrameLimit(config.performance.vsync ? 0 : config.performance.targetFPS);
     
     // Mouse lock state
     bool mouseLocked = false;
@@ -135,10 +141,9 @@ int main() {
     
     // Main render loop
     while (!glfwWindowShouldClose(window)) {
-        // Calculate delta time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        // Nothing is simulated here, so the ticks are unused
+        frameClock.beginFrame();
+        float deltaTime = frameClock.getFrameSeconds();
         
         // Start the ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -251,8 +256,8 @@ int main() {
                 hutModel->setRandomSeed(seed);
             }
             
+            // Only the chunks touched by the new model are remeshed on the next render
             hutModel->generateHut(currentHutType, withFurnishings);
-            hutModel->createVoxelObjects(blockRegistry);
             
             // Output some info
             int p, q, r;
@@ -263,6 +268,22 @@ int main() {
                       << blockCount << " blocks in a " << p << "x" << q << "x" << r << " volume" << std::endl;
         }
         
+        // Debug colourings of the chunks, nothing is built or drawn for them when off
+        if (ImGui::BeginCombo("Debug View", Zenith::BaseModel::getDebugViewName(hutModel->getDebugView()))) {
+            for (int i = 0; i < Zenith::CHUNK_DEBUG_VIEW_COUNT; i++) {
+                Zenith::ChunkDebugView debugView = static_cast<Zenith::ChunkDebugView>(i);
+                if (ImGui::Selectable(Zenith::BaseModel::getDebugViewName(debugView), hutModel->getDebugView() == debugView)) {
+                    hutModel->setDebugView(debugView);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        
+        float timeOfDay = dayNightCycle.getTime();
+        if (ImGui::SliderFloat("Time of Day", &timeOfDay, 0.0f, 24.0f, "%.2f h")) {
+            dayNightCycle.setTime(timeOfDay);
+        }
+        
         // Display model information
         ImGui::Separator();
         ImGui::Text("Hut Model Information:");
@@ -274,10 +295,17 @@ int main() {
         ImGui::Text("Model Dimensions: %d x %d x %d", p, q, r);
         ImGui::Text("Total Blocks: %zu", blockCount);
         
+        const Zenith::ChunkRebuildStats& rebuildStats = hutModel->getLastRebuildStats();
+        ImGui::Text("Last Remesh: %zu chunks in %.3f ms", rebuildStats.chunksRebuilt, rebuildStats.milliseconds);
+        
         ImGui::End();
         
-        // Clear the screen
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        // Clear the screen, to black for the overdraw view which adds up from it
+        if (hutModel->getDebugView() == Zenith::ChunkDebugView::OVERDRAW) {
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        } else {
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        }
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
         // Create transformation matrices
@@ -290,13 +318,21 @@ int main() {
         );
         
         // Render the hut model
-        hutModel->render(view, projection, lightDir, lightColor, camera.getPosition());
+        const Zenith::SkyLighting& lighting = dayNightCycle.getLighting();
+        hutModel->setAmbientStrength(lighting.ambientStrength);
+        Zenith::Lightmap::shared().setSunBrightness(lighting.sunBrightness);
+        hutModel->render(view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
+        hutModel->renderTranslucent(view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
         
         // Render ImGui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         
-        // Swap buffers and poll events
+        // Recycle chunk buffer ranges the GPU is done with
+        Zenith::ChunkBufferPool::shared().endFrame();
+        
+        // Hold the frame limit, then swap buffers and poll events
+        frameClock.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
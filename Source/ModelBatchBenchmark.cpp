@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include "World/Models/ModelBatchGenerator.h"
+
+// Trees per second a batch should reach
+const double kTreeTargetPerSecond = 10000.0;
+
+// Hash of a batch in model order, so a model generated at the wrong index
+// changes it too. Used to check that every thread count produces exactly the
+// same models.
+template <typename ModelType>
+uint64_t hashBatch(const std::vector<std::unique_ptr<ModelType>>& models) {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    
+    for (const auto& model : models) {
+        std::vector<Zenith::VoxelPosition> positions = model->getOccupiedPositions();
+        mix(positions.size());
+        for (const auto& pos : positions) {
+            mix((static_cast<uint64_t>(pos.x) << 40) ^ (static_cast<uint64_t>(pos.y) << 20) ^ static_cast<uint64_t>(pos.z));
+            mix(std::hash<std::string>{}(model->getBlockType(pos.x, pos.y, pos.z)));
+        }
+    }
+    return hash;
+}
+
+template <typename GenerateFunc>
+void runBenchmark(const char* label, size_t count, const std::vector<unsigned int>& threadCounts,
+                  double targetPerSecond, GenerateFunc generate) {
+    std::cout << label << " (" << count << " models)" << std::endl;
+    
+    uint64_t referenceHash = 0;
+    bool deterministic = true;
+    
+    for (unsigned int threads : threadCounts) {
+        Zenith::ModelBatchGenerator generator(threads);
+        
+        auto start = std::chrono::steady_clock::now();
+        auto models = generate(generator);
+        auto end = std::chrono::steady_clock::now();
+        
+        double seconds = std::chrono::duration<double>(end - start).count();
+        uint64_t hash = hashBatch(models);
+        if (threads == threadCounts.front()) {
+            referenceHash = hash;
+        } else if (hash != referenceHash) {
+            deterministic = false;
+        }
+        
+        std::cout << "  " << std::setw(2) << threads << " thread(s): "
+                  << std::fixed << std::setprecision(1) << std::setw(10) << count / seconds << " models/s  "
+                  << std::setprecision(2) << seconds * 1000.0 << " ms  hash " << std::hex << hash << std::dec;
+        
+        // 0 for batches without a target
+        if (targetPerSecond > 0.0) {
+            std::cout << "  " << (count / seconds >= targetPerSecond ? "PASS" : "FAIL");
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << "  Deterministic across thread counts: " << (deterministic ? "yes" : "NO") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 10000;
+    uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 12345;
+    
+    std::cout << "Zenith Model Batch Benchmark" << std::endl;
+    std::cout << "============================" << std::endl;
+    std::cout << "Seed: " << seed << ", target: " << std::fixed << std::setprecision(0) << kTreeTargetPerSecond
+              << " trees/s" << std::endl << std::endl;
+    
+    // Single threaded first so it serves as the reference hash
+    std::vector<unsigned int> threadCounts = { 1 };
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 2; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    if (hardwareThreads > 1) {
+        threadCounts.push_back(hardwareThreads);
+    }
+    
+    runBenchmark("Trees", count, threadCounts, kTreeTargetPerSecond, [&](const Zenith::ModelBatchGenerator& generator) {
+        return generator.generateTrees(count, seed);
+    });
+    std::cout << std::endl;
+    
+    runBenchmark("Huts", count, threadCounts, 0.0, [&](const Zenith::ModelBatchGenerator& generator) {
+        return generator.generateHuts(count, seed);
+    });
+    
+    return 0;
+}
@@ -0,0 +1,56 @@
+#version 330 core
+out vec4 FragColor;
+
+// Debug colourings of the chunk passes (see BaseModel::setDebugView). Paired with
+// the chunk vertex shaders; the view is picked with a define, so none of this
+// code is compiled into the normal chunk program.
+in vec2 TexCoord;
+in vec3 FragPos;
+in vec3 Normal;
+flat in float Layer;
+
+uniform sampler2DArray blockTextures;
+
+uniform vec3 debugColor;    // Per chunk: its detail level, vertex count or tint
+uniform float quadSize;     // Blocks covered by a face at the chunk's detail level
+uniform vec3 gridOrigin;    // World position of the corner of chunk (0, 0, 0)
+
+// Blue through green and yellow to red as t goes from 0 to 1
+vec3 heat(float t) {
+    t = clamp(t, 0.0, 1.0);
+    return clamp(vec3(4.0 * t - 2.0, 2.0 - abs(4.0 * t - 2.0), 2.0 - 4.0 * t), 0.0, 1.0);
+}
+
+// Faces turned differently get different brightness so shapes stay readable
+float faceShade() {
+    return 0.6 + 0.4 * abs(dot(normalize(Normal), normalize(vec3(0.3, 1.0, 0.5))));
+}
+
+void main() {
+#ifdef ALPHA_TEST
+    if (texture(blockTextures, vec3(TexCoord, Layer)).a < 0.1)
+        discard;
+#endif
+
+#if defined(DEBUG_OVERDRAW)
+    // Added up with GL_ONE, GL_ONE: about ten layers saturate to white
+    FragColor = vec4(0.1, 0.06, 0.03, 1.0);
+#elif defined(DEBUG_TRIANGLE_DENSITY)
+    // Texture coordinates run one unit per block across the face plane, so the
+    // area they cover per pixel gives the faces, and the triangles, per pixel
+    vec2 dx = dFdx(TexCoord);
+    vec2 dy = dFdy(TexCoord);
+    float trianglesPerPixel = 2.0 * abs(dx.x * dy.y - dx.y * dy.x) / (quadSize * quadSize);
+
+    // 1/256 triangle per pixel or less is blue, one or more is red
+    FragColor = vec4(heat(log2(max(trianglesPerPixel, 1e-6)) / 8.0 + 1.0), 1.0);
+#elif defined(DEBUG_CHUNK_BOUNDS)
+    // Distance to the nearest chunk border in pixels, on the two axes across the face
+    vec3 cell = (FragPos - gridOrigin) / 16.0;
+    vec3 border = abs(fract(cell - 0.5) - 0.5) / max(fwidth(cell), vec3(1e-6)) + abs(Normal) * 1e6;
+    float line = 1.0 - clamp(min(border.x, min(border.y, border.z)) - 0.5, 0.0, 1.0);
+    FragColor = vec4(mix(debugColor * faceShade(), vec3(1.0), line), 1.0);
+#else
+    FragColor = vec4(debugColor * faceShade(), 1.0);
+#endif
+}
@@ -0,0 +1,94 @@
+#version 430 core
+
+// Vertex pulling: no per-vertex attributes, each face is one ChunkFace record (see
+// ChunkVertex.h) expanded into two triangles. Draw with glDrawArrays(faces * 6).
+layout(std430, binding = 0) readonly buffer ChunkFaces {
+    uvec2 faces[];
+};
+
+layout(location = 7) in vec3 aChunkOrigin; // Chunk offset inside the model, one per draw
+
+uniform mat4 model;   // Model position, chunks are placed by aChunkOrigin
+uniform mat4 view;
+uniform mat4 projection;
+
+// The depth pre-pass and the shading pass run different fragment shaders over
+// the same vertices; their depths must match exactly for GL_LEQUAL to pass
+invariant gl_Position;
+
+out vec2 TexCoord;
+out vec3 FragPos;
+out vec3 Normal;
+#ifdef ENABLE_SHADOWS
+out float ViewDepth;    // Distance along the view direction, picks the shadow cascade
+#endif
+flat out float Layer;       // Layer in the block texture array
+#ifdef ENABLE_AO
+out float AmbientOcclusion;
+#endif
+flat out vec2 Light;        // Sky and block light levels, 0..15
+
+// Corners of each face relative to its cell, same order as kFaceCorners in ChunkMesher.cpp
+const vec3 kFaceCorners[24] = vec3[24](
+    vec3(0, 1, 0), vec3(1, 1, 0), vec3(1, 1, 1), vec3(0, 1, 1),   // TOP
+    vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 0, 1), vec3(0, 0, 1),   // BOTTOM
+    vec3(0, 0, 1), vec3(1, 0, 1), vec3(1, 1, 1), vec3(0, 1, 1),   // FRONT
+    vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 1, 0), vec3(0, 1, 0),   // BACK
+    vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0),   // LEFT
+    vec3(1, 0, 0), vec3(1, 0, 1), vec3(1, 1, 1), vec3(1, 1, 0)    // RIGHT
+);
+
+// Quad corner used by each of the six vertices, same triangles as the shared index
+// buffer, and the same rotated by one for faces split along the other diagonal
+const int kQuadCorners[6] = int[6](0, 1, 2, 2, 3, 0);
+const int kFlippedQuadCorners[6] = int[6](1, 2, 3, 3, 0, 1);
+
+// Face normals in Voxel order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+const vec3 kFaceNormals[6] = vec3[6](
+    vec3( 0.0,  1.0,  0.0),
+    vec3( 0.0, -1.0,  0.0),
+    vec3( 0.0,  0.0,  1.0),
+    vec3( 0.0,  0.0, -1.0),
+    vec3(-1.0,  0.0,  0.0),
+    vec3( 1.0,  0.0,  0.0)
+);
+
+// Texture coordinates are the corner position projected on the face plane,
+// oriented like the cube in Voxel::initialize
+vec2 faceTexCoord(vec3 corner, uint face) {
+    if (face == 0u) return vec2( corner.x,  corner.z);
+    if (face == 1u) return vec2( corner.x, -corner.z);
+    if (face == 2u) return vec2( corner.x, -corner.y);
+    if (face == 3u) return vec2(-corner.x, -corner.y);
+    if (face == 4u) return vec2( corner.z, -corner.y);
+    return vec2(-corner.z, -corner.y);
+}
+
+void main() {
+    uvec2 record = faces[gl_VertexID / 6];
+    uint data0 = record.x;
+    uint data1 = record.y;
+    bool flipped = ((data0 >> 28) & 1u) != 0u;
+    int quadCorner = flipped ? kFlippedQuadCorners[gl_VertexID % 6] : kQuadCorners[gl_VertexID % 6];
+
+    vec3 cell = vec3(float(data0 & 31u), float((data0 >> 5) & 31u), float((data0 >> 10) & 31u));
+    uint face = (data0 >> 15) & 7u;
+    float size = float(1u << ((data0 >> 18) & 3u));
+
+    // Corners sit on block edges, blocks are centred on their coordinates
+    vec3 corner = cell + kFaceCorners[face * 4u + uint(quadCorner)] * size;
+
+    FragPos = vec3(model * vec4(aChunkOrigin + corner - 0.5, 1.0));
+    Normal = kFaceNormals[face];
+#ifdef ENABLE_SHADOWS
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
+#endif
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+    TexCoord = faceTexCoord(corner, face);
+    Layer = float(data1 & 0xFFFFu);
+#ifdef ENABLE_AO
+    AmbientOcclusion = float((data0 >> (20 + 2 * quadCorner)) & 3u) / 3.0;
+#endif
+    Light = vec2(float((data1 >> 16) & 15u), float((data1 >> 20) & 15u));
+}
@@ -0,0 +1,99 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec3 FragPos;
+in vec3 Normal;
+#ifdef ENABLE_SHADOWS
+in float ViewDepth;
+#endif
+flat in float Layer;
+#ifdef ENABLE_AO
+in float AmbientOcclusion;
+#endif
+flat in vec2 Light;
+
+// Every block face texture, one layer each (see BlockTextureArray)
+uniform sampler2DArray blockTextures;
+
+// Flood-filled light levels to colours, see Lightmap
+uniform sampler2D lightmap;
+uniform float sunBrightness;
+
+// Lighting uniforms
+uniform vec3 lightDir;
+uniform vec3 lightColor;
+uniform vec3 viewPos;
+uniform float ambientStrength;
+
+#ifdef ENABLE_SHADOWS
+#include "shadow_cascades.glsl"
+#endif
+
+#ifdef ENABLE_FOG
+// Distance fog, blends to fogColor between fogStart and fogEnd from the camera
+uniform vec3 fogColor;
+uniform float fogStart;
+uniform float fogEnd;
+#endif
+
+void main() {
+    vec4 texColor = texture(blockTextures, vec3(TexCoord, Layer));
+    
+#ifdef ALPHA_TEST
+    // Discard transparent pixels (leaves, glass). Only this variant discards, so
+    // the opaque pass keeps early depth testing.
+    if(texColor.a < 0.1)
+        discard;
+#endif
+    
+#ifdef ENABLE_AO
+    // Baked per-vertex occlusion darkens ambient and diffuse light in corners,
+    // fully occluded corners keep some light so interiors don't go black
+    float occlusion = mix(0.35, 1.0, AmbientOcclusion);
+#else
+    float occlusion = 1.0;
+#endif
+    
+    // Sky rows of the lightmap follow the time of day, block rows are fixed
+    vec3 skyLight = texture(lightmap, vec2(sunBrightness, (Light.x + 0.5) / 32.0)).rgb;
+    vec3 blockLight = texture(lightmap, vec2(0.5, (Light.y + 16.5) / 32.0)).rgb;
+    
+    // The sun only reaches cells open to the sky
+    float skyExposure = Light.x / 15.0;
+    
+    vec3 ambient = ambientStrength * occlusion * skyLight * lightColor + occlusion * blockLight;
+    
+    // Diffuse lighting
+    vec3 norm = normalize(Normal);
+    vec3 lightDirection = normalize(-lightDir);
+    float diff = max(dot(norm, lightDirection), 0.0);
+    vec3 diffuse = diff * occlusion * lightColor;
+    
+#ifdef ENABLE_SPECULAR
+    // Specular lighting
+    float specularStrength = 0.3;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDirection, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 16);
+    vec3 specular = specularStrength * spec * lightColor;
+#else
+    vec3 specular = vec3(0.0);
+#endif
+    
+    // Calculate shadow, fully lit when shadows are compiled out
+#ifdef ENABLE_SHADOWS
+    float shadow = ShadowCalculation(FragPos, ViewDepth, norm, lightDir);
+#else
+    float shadow = 0.0;
+#endif
+    
+    // Combine lighting components with shadow
+    vec3 result = (ambient + (1.0 - shadow) * skyExposure * (diffuse + specular)) * texColor.rgb;
+    
+#ifdef ENABLE_FOG
+    result = mix(result, fogColor, smoothstep(fogStart, fogEnd, length(viewPos - FragPos)));
+#endif
+    
+    FragColor = vec4(result, texColor.a);
+}
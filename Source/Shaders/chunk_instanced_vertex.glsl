@@ -0,0 +1,67 @@
+#version 330 core
+layout(location = 0) in uvec2 aPacked;   // Packed chunk vertex, see ChunkVertex.h
+layout(location = 3) in mat4 aInstance;  // Per-instance placement (locations 3-6)
+
+uniform mat4 model;   // Offset of the chunk inside the prefab
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec2 TexCoord;
+out vec3 FragPos;
+out vec3 Normal;
+#ifdef ENABLE_SHADOWS
+out float ViewDepth;    // Distance along the view direction, picks the shadow cascade
+#endif
+flat out float Layer;       // Layer in the block texture array
+#ifdef ENABLE_AO
+out float AmbientOcclusion;
+#endif
+flat out vec2 Light;        // Sky and block light levels, 0..15
+
+// Face normals in Voxel order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+const vec3 kFaceNormals[6] = vec3[6](
+    vec3( 0.0,  1.0,  0.0),
+    vec3( 0.0, -1.0,  0.0),
+    vec3( 0.0,  0.0,  1.0),
+    vec3( 0.0,  0.0, -1.0),
+    vec3(-1.0,  0.0,  0.0),
+    vec3( 1.0,  0.0,  0.0)
+);
+
+// Texture coordinates are the corner position projected on the face plane,
+// oriented like the cube in Voxel::initialize
+vec2 faceTexCoord(vec3 corner, uint face) {
+    if (face == 0u) return vec2( corner.x,  corner.z);
+    if (face == 1u) return vec2( corner.x, -corner.z);
+    if (face == 2u) return vec2( corner.x, -corner.y);
+    if (face == 3u) return vec2(-corner.x, -corner.y);
+    if (face == 4u) return vec2( corner.z, -corner.y);
+    return vec2(-corner.z, -corner.y);
+}
+
+void main() {
+    uint data0 = aPacked.x;
+    uint data1 = aPacked.y;
+
+    // Corners sit on block edges, blocks are centred on their coordinates
+    vec3 corner = vec3(float(data0 & 31u), float((data0 >> 5) & 31u), float((data0 >> 10) & 31u));
+    uint face = (data0 >> 15) & 7u;
+
+    mat4 instanceModel = aInstance * model;
+    FragPos = vec3(instanceModel * vec4(corner - 0.5, 1.0));
+
+    // Placements only rotate by quarter turns and mirror, so the matrix is
+    // orthogonal and needs no inverse transpose
+    Normal = mat3(instanceModel) * kFaceNormals[face];
+#ifdef ENABLE_SHADOWS
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
+#endif
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+    TexCoord = faceTexCoord(corner, face);
+    Layer = float(data1 & 0xFFFFu);
+#ifdef ENABLE_AO
+    AmbientOcclusion = float((data0 >> 18) & 3u) / 3.0;
+#endif
+    Light = vec2(float((data1 >> 16) & 15u), float((data1 >> 20) & 15u));
+}
@@ -0,0 +1,7 @@
+#version 330 core
+out vec4 FragColor;
+
+// Colour writes are masked off, only the occlusion query counts the samples
+void main() {
+    FragColor = vec4(1.0);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;    // Unit cube corner
+
+uniform mat4 viewProjection;
+uniform vec3 boxMin;
+uniform vec3 boxSize;
+
+void main() {
+    gl_Position = viewProjection * vec4(boxMin + aPos * boxSize, 1.0);
+}
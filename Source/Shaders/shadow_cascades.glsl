@@ -0,0 +1,59 @@
+// Cascaded shadow map lookups, included by the lit fragment shaders when
+// ENABLE_SHADOWS is defined. The maps are filled by the directional light's
+// depth passes (see ShadowMap).
+#define MAX_SHADOW_CASCADES 4
+uniform sampler2DArray shadowMap;
+uniform mat4 lightSpaceMatrices[MAX_SHADOW_CASCADES];
+uniform float cascadeSplits[MAX_SHADOW_CASCADES];  // View depth where each cascade ends
+uniform int cascadeCount;
+
+// Fraction of the PCF kernel in shadow, 0 when fully lit. `lightDirection`
+// points from the light into the scene.
+float ShadowCalculation(vec3 fragPos, float viewDepth, vec3 normal, vec3 lightDirection) {
+    // Beyond the last cascade nothing is shadowed
+    if(viewDepth > cascadeSplits[cascadeCount - 1])
+        return 0.0;
+
+    int cascade = 0;
+    while(cascade < cascadeCount - 1 && viewDepth > cascadeSplits[cascade])
+        cascade++;
+
+    // Far cascades are re-rendered every few frames and can lag behind the camera,
+    // fall through to a wider one when the fragment isn't covered
+    vec3 projCoords;
+    for(; cascade < cascadeCount; ++cascade) {
+        vec4 fragPosLightSpace = lightSpaceMatrices[cascade] * vec4(fragPos, 1.0);
+
+        // Perform perspective divide and transform to [0,1] range
+        projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+
+        if(projCoords.x >= 0.0 && projCoords.x <= 1.0 &&
+           projCoords.y >= 0.0 && projCoords.y <= 1.0 &&
+           projCoords.z >= 0.0 && projCoords.z <= 1.0)
+            break;
+    }
+    if(cascade == cascadeCount)
+        return 0.0; // No shadow outside bounds
+
+    // Get current depth
+    float currentDepth = projCoords.z;
+
+    // Calculate bias based on surface angle relative to light
+    float bias = max(0.025 * (1.0 - dot(normal, -normalize(lightDirection))), 0.0025);
+
+    // PCF (Percentage Closer Filtering) for softer shadows
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    int pcfRadius = 2;
+
+    for(int x = -pcfRadius; x <= pcfRadius; ++x) {
+        for(int y = -pcfRadius; y <= pcfRadius; ++y) {
+            float pcfDepth = texture(shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, float(cascade))).r;
+            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
+        }
+    }
+
+    shadow /= ((2 * pcfRadius + 1) * (2 * pcfRadius + 1));
+
+    return shadow;
+}
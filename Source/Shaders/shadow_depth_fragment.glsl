@@ -0,0 +1,17 @@
+#version 330 core
+
+// Depth-only pass from the directional light (see ShadowMap). Paired with the chunk
+// vertex shaders, with the light's matrix as projection and an identity view.
+// Without ALPHA_TEST it also serves the camera's depth pre-pass over opaque chunks.
+in vec2 TexCoord;
+flat in float Layer;
+
+uniform sampler2DArray blockTextures;
+
+void main() {
+#ifdef ALPHA_TEST
+    // Leaves and glass only cast shadows where they are opaque
+    if (texture(blockTextures, vec3(TexCoord, Layer)).a < 0.1)
+        discard;
+#endif
+}
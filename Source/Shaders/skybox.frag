@@ -4,8 +4,12 @@ out vec4 FragColor;
 in vec3 TexCoords;
 
 uniform samplerCube skybox;
+uniform samplerCube skyboxBlend;
+uniform float blend;
+uniform vec3 tint;
 
 void main()
 {    
-    FragColor = texture(skybox, TexCoords);
-}
\ No newline at end of file
+    vec4 sky = mix(texture(skybox, TexCoords), texture(skyboxBlend, TexCoords), blend);
+    FragColor = vec4(sky.rgb * tint, sky.a);
+}
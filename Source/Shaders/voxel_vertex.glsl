@@ -6,12 +6,14 @@ layout(location = 2) in vec2 aTexCoord;   // Texture coordinates
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;  // For shadow mapping
 
 out vec2 TexCoord;
 out vec3 FragPos;     
 out vec3 Normal;      
-out vec4 FragPosLightSpace;
+flat out int Face;      // TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT, indexes faceLayers
+#ifdef ENABLE_SHADOWS
+out float ViewDepth;    // Distance along the view direction, picks the shadow cascade
+#endif
 
 void main() {
     // Calculate position in world space
@@ -20,8 +22,21 @@ void main() {
     // Calculate normal in world space (for lighting)
     Normal = mat3(transpose(inverse(model))) * aNormal;
     
-    // Calculate position in light space (for shadow mapping)
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    // The cube's faces are flat, so the face can be picked once per vertex from
+    // the dominant axis of the model space normal
+    vec3 absNormal = abs(aNormal);
+    if(absNormal.y > absNormal.x && absNormal.y > absNormal.z) {
+        Face = aNormal.y > 0.0 ? 0 : 1;
+    } else if(absNormal.z > absNormal.x && absNormal.z > absNormal.y) {
+        Face = aNormal.z > 0.0 ? 2 : 3;
+    } else {
+        Face = aNormal.x < 0.0 ? 4 : 5;
+    }
+    
+#ifdef ENABLE_SHADOWS
+    // Calculate view depth (for picking the shadow cascade)
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
+#endif
     
     // Calculate final position in clip space
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -0,0 +1,102 @@
+#include "FrameClock.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace Zenith {
+
+namespace {
+
+// Left for yielding when the limiter sleeps, covers the usual sleep overshoot
+const std::chrono::microseconds kSpinMargin(1500);
+
+} // namespace
+
+FrameClock::FrameClock(double ticksPerSecond)
+    : m_tickSeconds(1.0 / 60.0), m_frameLimit(0), m_started(false), m_frameSeconds(0.0), m_accumulator(0.0),
+      m_history{}, m_historyCount(0), m_historyNext(0)
+{
+    setTickRate(ticksPerSecond);
+}
+
+void FrameClock::setTickRate(double ticksPerSecond) {
+    if (ticksPerSecond > 0.0) {
+        m_tickSeconds = 1.0 / ticksPerSecond;
+    }
+}
+
+void FrameClock::setFrameLimit(int framesPerSecond) {
+    m_frameLimit = std::max(framesPerSecond, 0);
+}
+
+int FrameClock::beginFrame() {
+    Clock::time_point now = Clock::now();
+    if (!m_started) {
+        m_started = true;
+        m_frameStart = now;
+        m_frameSeconds = 0.0;
+        m_stats.ticks = 0;
+        return 0;
+    }
+
+    m_frameSeconds = std::chrono::duration<double>(now - m_frameStart).count();
+    m_frameStart = now;
+
+    m_accumulator += m_frameSeconds;
+    int ticks = static_cast<int>(m_accumulator / m_tickSeconds);
+    if (ticks > MAX_TICKS_PER_FRAME) {
+        m_stats.droppedTicks += ticks - MAX_TICKS_PER_FRAME;
+        ticks = MAX_TICKS_PER_FRAME;
+        m_accumulator = 0.0;
+    } else {
+        m_accumulator -= ticks * m_tickSeconds;
+    }
+    m_stats.ticks = ticks;
+
+    // Pacing over the recent frames
+    m_history[m_historyNext] = m_frameSeconds * 1000.0;
+    m_historyNext = (m_historyNext + 1) % FRAME_HISTORY;
+    m_historyCount = std::min(m_historyCount + 1, static_cast<size_t>(FRAME_HISTORY));
+
+    double sum = 0.0;
+    double worst = 0.0;
+    for (size_t i = 0; i < m_historyCount; i++) {
+        sum += m_history[i];
+        worst = std::max(worst, m_history[i]);
+    }
+    double average = sum / m_historyCount;
+    double variance = 0.0;
+    for (size_t i = 0; i < m_historyCount; i++) {
+        variance += (m_history[i] - average) * (m_history[i] - average);
+    }
+
+    m_stats.frameMs = m_frameSeconds * 1000.0;
+    m_stats.averageMs = average;
+    m_stats.worstMs = worst;
+    m_stats.jitterMs = std::sqrt(variance / m_historyCount);
+    return ticks;
+}
+
+void FrameClock::endFrame() {
+    m_stats.waitMs = 0.0;
+    if (m_frameLimit <= 0 || !m_started) {
+        return;
+    }
+
+    Clock::time_point deadline = m_frameStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_frameLimit));
+    Clock::time_point start = Clock::now();
+    if (start >= deadline) {
+        return;
+    }
+
+    if (deadline - start > kSpinMargin) {
+        std::this_thread::sleep_until(deadline - kSpinMargin);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    m_stats.waitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace Zenith
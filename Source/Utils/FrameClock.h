@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace Zenith {
+
+// Frame timing over the last FrameClock::FRAME_HISTORY frames, for the viewers' stats
+struct FramePacingStats {
+    double frameMs = 0.0;       // Last frame, start to start
+    double averageMs = 0.0;
+    double worstMs = 0.0;
+    double jitterMs = 0.0;      // Standard deviation of the frame times
+    double waitMs = 0.0;        // Spent by the frame limiter in the last frame
+    int ticks = 0;              // Simulation ticks due in the last frame
+    size_t droppedTicks = 0;    // Since startup, skipped because a frame fell too far behind
+};
+
+// Main loop timing. Input and rendering run once per frame with the real frame
+// time; the simulation runs in fixed ticks, so it behaves the same at any frame
+// rate. Each beginFrame() adds the time since the previous frame to an
+// accumulator and returns how many whole ticks it holds; the loop runs that many
+// ticks, then renders between the last two simulation states using getAlpha().
+//
+// A frame far behind (a stall, a breakpoint) runs at most MAX_TICKS_PER_FRAME
+// ticks and drops the rest instead of spiralling into ever longer frames.
+//
+// With a frame limit, endFrame() waits out the rest of the frame: sleeping until
+// shortly before the deadline, then yielding, since sleeps overshoot by up to a
+// scheduler quantum.
+class FrameClock {
+public:
+    static constexpr int MAX_TICKS_PER_FRAME = 8;
+    static constexpr int FRAME_HISTORY = 120;
+
+    explicit FrameClock(double ticksPerSecond = 60.0);
+
+    void setTickRate(double ticksPerSecond);
+    double getTickSeconds() const { return m_tickSeconds; }
+
+    // Frames per second to hold the loop to, 0 for no limit. Meant for when vsync
+    // is off; with it on the swap already paces the loop.
+    void setFrameLimit(int framesPerSecond);
+    int getFrameLimit() const { return m_frameLimit; }
+
+    // Start a frame. Returns the number of simulation ticks due, 0 on the first frame.
+    int beginFrame();
+
+    // Real time since the previous frame, for input and camera movement
+    float getFrameSeconds() const { return static_cast<float>(m_frameSeconds); }
+
+    // How far into the next tick this frame is, 0..1: the weight of the latest
+    // simulation state against the one before it
+    float getAlpha() const { return static_cast<float>(m_accumulator / m_tickSeconds); }
+
+    // Wait for the frame limit, call right before swapping buffers
+    void endFrame();
+
+    const FramePacingStats& getStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_tickSeconds;
+    int m_frameLimit;
+
+    bool m_started;
+    Clock::time_point m_frameStart;
+    double m_frameSeconds;
+    double m_accumulator;   // Simulation time not yet ticked, less than a tick after beginFrame()
+
+    // Ring of recent frame times in milliseconds
+    std::array<double, FRAME_HISTORY> m_history;
+    size_t m_historyCount;
+    size_t m_historyNext;
+
+    FramePacingStats m_stats;
+};
+
+} // namespace Zenith
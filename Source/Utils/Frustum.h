@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// View frustum as six planes extracted from a view-projection matrix
+// (Gribb/Hartmann). Planes point inwards and are normalized.
+class Frustum {
+public:
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection) { update(viewProjection); }
+
+    void update(const glm::mat4& viewProjection) {
+        glm::mat4 m = glm::transpose(viewProjection);
+        m_planes[0] = m[3] + m[0];  // Left
+        m_planes[1] = m[3] - m[0];  // Right
+        m_planes[2] = m[3] + m[1];  // Bottom
+        m_planes[3] = m[3] - m[1];  // Top
+        m_planes[4] = m[3] + m[2];  // Near
+        m_planes[5] = m[3] - m[2];  // Far
+
+        for (glm::vec4& plane : m_planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    // False only if the box is entirely outside one plane (may keep some boxes
+    // that are outside near the frustum corners, which is fine for culling)
+    bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+        for (const glm::vec4& plane : m_planes) {
+            // Corner of the box furthest along the plane normal
+            glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                             plane.y >= 0.0f ? max.y : min.y,
+                             plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::array<glm::vec4, 6> m_planes{};
+};
+
+} // namespace Zenith
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace Zenith {
+
+/**
+ * Philox4x32-10 counter-based random number generator.
+ *
+ * Every (seed, stream) pair is an independent sequence that can be created
+ * directly, without generating the streams before it. Batch generation keys a
+ * stream per model index so results don't depend on which thread built which
+ * model. Satisfies UniformRandomBitGenerator, but prefer uniformInt() over the
+ * std distributions: their output differs between standard libraries.
+ */
+class PhiloxRng {
+public:
+    using result_type = uint32_t;
+
+    explicit PhiloxRng(uint64_t seed = 0, uint64_t stream = 0) {
+        this->seed(seed, stream);
+    }
+
+    /**
+     * Restart the generator at the beginning of a stream
+     * @param seed Key of the generator
+     * @param stream Index of the sequence to use for this key
+     */
+    void seed(uint64_t seed, uint64_t stream = 0) {
+        m_key = { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) };
+        m_counter = { 0, 0, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) };
+        m_next = 4;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (m_next == 4) {
+            m_block = generateBlock(m_counter, m_key);
+            // The low 64 bits count blocks, the high 64 bits hold the stream
+            if (++m_counter[0] == 0) {
+                ++m_counter[1];
+            }
+            m_next = 0;
+        }
+        return m_block[m_next++];
+    }
+
+    /**
+     * Uniform integer in [min, max] (Lemire's multiply-shift with rejection)
+     */
+    int uniformInt(int min, int max) {
+        uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1u;
+        if (range == 0) {
+            return static_cast<int>((*this)()); // Full 32-bit range
+        }
+
+        uint64_t product = static_cast<uint64_t>((*this)()) * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+            uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                product = static_cast<uint64_t>((*this)()) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(static_cast<uint32_t>(min) + static_cast<uint32_t>(product >> 32));
+    }
+
+    /**
+     * Uniform float in [0, 1)
+     */
+    float uniformFloat() {
+        return static_cast<float>((*this)() >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    static std::array<uint32_t, 4> generateBlock(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+        const uint32_t M0 = 0xD2511F53u;
+        const uint32_t M1 = 0xCD9E8D57u;
+        const uint32_t W0 = 0x9E3779B9u;
+        const uint32_t W1 = 0xBB67AE85u;
+
+        for (int round = 0; round < 10; round++) {
+            if (round > 0) {
+                key[0] += W0;
+                key[1] += W1;
+            }
+
+            uint64_t product0 = static_cast<uint64_t>(M0) * counter[0];
+            uint64_t product1 = static_cast<uint64_t>(M1) * counter[2];
+            counter = {
+                static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(product1),
+                static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(product0)
+            };
+        }
+        return counter;
+    }
+
+    std::array<uint32_t, 4> m_counter;
+    std::array<uint32_t, 2> m_key;
+    std::array<uint32_t, 4> m_block;
+    int m_next;
+};
+
+} // namespace Zenith
@@ -0,0 +1,303 @@
+#include "ShaderCache.h"
+#include "ShaderUtils.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace Zenith {
+
+namespace {
+
+// Binary file layout: magic, format version, the driver's binary format, then
+// the binary itself
+const uint32_t kBinaryMagic = 0x4248535A;   // "ZSHB"
+const uint32_t kBinaryVersion = 1;
+
+// FNV-1a, stable across runs and platforms unlike std::hash
+uint64_t hashBytes(const std::string& bytes, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+ShaderCache& ShaderCache::shared() {
+    static ShaderCache cache;
+    return cache;
+}
+
+ShaderCache::ShaderCache()
+    : m_binaryDirectory(SHADER_CACHE_DIR)
+{
+}
+
+unsigned int ShaderCache::getProgram(const std::string& vertexPath, const std::string& fragmentPath,
+                                     const std::vector<std::string>& defines) {
+    std::string key = vertexPath + '\n' + fragmentPath;
+    for (const std::string& define : defines) {
+        key += '\n' + define;
+    }
+    
+    auto it = m_programs.find(key);
+    if (it != m_programs.end()) {
+        return it->second.program;
+    }
+    
+    Entry entry;
+    entry.vertexPath = vertexPath;
+    entry.fragmentPath = fragmentPath;
+    entry.defines = defines;
+    
+    auto start = std::chrono::steady_clock::now();
+    unsigned int program = build(vertexPath, fragmentPath, defines, entry.dependencies);
+    auto end = std::chrono::steady_clock::now();
+    
+    if (program == 0) {
+        std::cerr << "Failed to build shader program " << vertexPath << " + " << fragmentPath;
+        for (const std::string& define : defines) {
+            std::cerr << " " << define;
+        }
+        std::cerr << std::endl;
+    }
+    
+    entry.program = program;
+    m_programs[key] = std::move(entry);
+    m_stats.programs++;
+    m_stats.milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+    return program;
+}
+
+unsigned int ShaderCache::getProgram(const std::string& vertexPath, const std::string& fragmentPath,
+                                     unsigned int features, const std::vector<std::string>& defines) {
+    std::vector<std::string> all = ShaderUtils::getFeatureDefines(features);
+    all.insert(all.end(), defines.begin(), defines.end());
+    return getProgram(vertexPath, fragmentPath, all);
+}
+
+bool ShaderCache::setHotReload(bool enabled) {
+    if (!enabled) {
+        m_watcher.stop();
+        return true;
+    }
+    return m_watcher.isWatching() || m_watcher.watch(SHADER_SOURCE_DIR);
+}
+
+size_t ShaderCache::reloadChanged() {
+    std::vector<std::string> names = m_watcher.poll();
+    if (names.empty()) {
+        return 0;
+    }
+    
+    // Bring the edited shaders over to where the programs are read from, skipping
+    // editors' swap and backup files like copy_shaders does
+    std::vector<std::filesystem::path> changed;
+    for (const std::string& name : names) {
+        std::filesystem::path extension = std::filesystem::path(name).extension();
+        if (extension != ".glsl" && extension != ".vert" && extension != ".frag") {
+            continue;
+        }
+        
+        std::filesystem::path source = std::filesystem::path(m_watcher.getDirectory()) / name;
+        std::filesystem::path target = std::filesystem::path(SHADER_DIR) / name;
+        std::error_code error;
+        if (!std::filesystem::equivalent(source, target, error)) {
+            std::filesystem::copy_file(source, target, std::filesystem::copy_options::overwrite_existing, error);
+            if (error) {
+                std::cerr << "Can't copy edited shader " << source << ": " << error.message() << std::endl;
+                continue;
+            }
+        }
+        changed.push_back(target.lexically_normal());
+    }
+    
+    size_t swapped = 0;
+    for (auto& item : m_programs) {
+        Entry& entry = item.second;
+        bool stale = false;
+        for (const std::string& dependency : entry.dependencies) {
+            std::filesystem::path path = std::filesystem::path(dependency).lexically_normal();
+            stale = stale || std::find(changed.begin(), changed.end(), path) != changed.end();
+        }
+        if (!stale) {
+            continue;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::string> dependencies;
+        unsigned int program = build(entry.vertexPath, entry.fragmentPath, entry.defines, dependencies);
+        m_stats.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        // An edit that doesn't compile mustn't take down the running program
+        if (program == 0) {
+            std::cerr << "Reloading " << entry.vertexPath << " + " << entry.fragmentPath
+                      << " failed, keeping the previous program" << std::endl;
+            m_stats.reloadFailures++;
+            continue;
+        }
+        
+        if (entry.program != 0) {
+            glDeleteProgram(entry.program);
+        }
+        entry.program = program;
+        entry.dependencies = dependencies;
+        m_stats.reloaded++;
+        swapped++;
+    }
+    return swapped;
+}
+
+unsigned int ShaderCache::build(const std::string& vertexPath, const std::string& fragmentPath,
+                                const std::vector<std::string>& defines, std::vector<std::string>& dependencies) {
+    // Even a program that fails to load depends on its two files, so fixing
+    // either one rebuilds it
+    dependencies = { vertexPath, fragmentPath };
+    
+    std::string vertexCode;
+    std::string fragmentCode;
+    std::vector<std::string> vertexFiles;
+    std::vector<std::string> fragmentFiles;
+    bool loaded = ShaderUtils::loadShaderSource(vertexPath, defines, vertexCode, &vertexFiles) &&
+                  ShaderUtils::loadShaderSource(fragmentPath, defines, fragmentCode, &fragmentFiles);
+    for (const std::vector<std::string>* files : { &vertexFiles, &fragmentFiles }) {
+        for (const std::string& file : *files) {
+            if (std::find(dependencies.begin(), dependencies.end(), file) == dependencies.end()) {
+                dependencies.push_back(file);
+            }
+        }
+    }
+    if (!loaded) {
+        return 0;
+    }
+    
+    bool binaries = !m_binaryDirectory.empty() && isBinarySupported();
+    std::string binaryPath;
+    if (binaries) {
+        binaryPath = getBinaryPath(vertexCode, fragmentCode);
+        unsigned int program = loadBinary(binaryPath);
+        if (program != 0) {
+            m_stats.binariesLoaded++;
+            return program;
+        }
+    }
+    
+    unsigned int program = ShaderUtils::linkShaderProgram(vertexCode, fragmentCode, binaries);
+    if (program == 0) {
+        return 0;
+    }
+    m_stats.compiled++;
+    
+    if (binaries && storeBinary(program, binaryPath)) {
+        m_stats.binariesStored++;
+    }
+    return program;
+}
+
+std::string ShaderCache::getBinaryPath(const std::string& vertexCode, const std::string& fragmentCode) {
+    // A binary only loads on the driver that produced it
+    if (m_driver.empty()) {
+        const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+        m_driver = std::string(renderer ? renderer : "") + '\n' + (version ? version : "");
+    }
+    
+    uint64_t hash = hashBytes(m_driver);
+    hash = hashBytes(vertexCode + '\0', hash);
+    hash = hashBytes(fragmentCode, hash);
+    
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return m_binaryDirectory + "/" + name;
+}
+
+unsigned int ShaderCache::loadBinary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+    
+    uint32_t header[3] = { 0, 0, 0 };
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || header[0] != kBinaryMagic || header[1] != kBinaryVersion) {
+        return 0;
+    }
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty()) {
+        return 0;
+    }
+    
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header[2], binary.data(), static_cast<GLsizei>(binary.size()));
+    
+    // Drivers refuse binaries from other versions, the caller compiles instead
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+bool ShaderCache::storeBinary(unsigned int program, const std::string& path) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false;
+    }
+    
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    
+    std::error_code error;
+    std::filesystem::path target(path);
+    std::filesystem::create_directories(target.parent_path(), error);
+    
+    // Written aside and renamed, so an interrupted run never leaves half a binary
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Can't write shader binary: " << temporary << std::endl;
+            return false;
+        }
+        uint32_t header[3] = { kBinaryMagic, kBinaryVersion, static_cast<uint32_t>(format) };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            return false;
+        }
+    }
+    
+    std::filesystem::rename(temporary, target, error);
+    return !error;
+}
+
+bool ShaderCache::isBinarySupported() {
+    if (!GLAD_GL_VERSION_4_1) {
+        return false;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+void ShaderCache::release() {
+    for (auto& entry : m_programs) {
+        if (entry.second.program != 0) {
+            glDeleteProgram(entry.second.program);
+        }
+    }
+    m_programs.clear();
+    m_watcher.stop();
+}
+
+} // namespace Zenith
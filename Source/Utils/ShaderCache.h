@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ShaderWatcher.h"
+
+namespace Zenith {
+
+// Counters since startup, for the viewers' stats
+struct ShaderCacheStats {
+    size_t programs = 0;        // Distinct programs asked for, failures included
+    size_t compiled = 0;        // Compiled and linked from source
+    size_t binariesLoaded = 0;  // Restored from a stored driver binary instead
+    size_t binariesStored = 0;
+    double milliseconds = 0.0;  // Spent building programs, either way
+    size_t reloaded = 0;        // Programs swapped for a rebuild after their sources were edited
+    size_t reloadFailures = 0;  // Rebuilds that failed, the previous program was kept
+};
+
+// Linked shader programs keyed by their source paths and defines. The first
+// request builds a program, later ones get the same one back, so callers can ask
+// every frame instead of keeping the id. Failures are cached too and only reported
+// once.
+//
+// With GL 4.1 program binaries, each program compiled from source is also written
+// to the binary directory under a hash of its sources (defines included) and the
+// GL renderer and version. The next run restores it with glProgramBinary instead
+// of compiling. A binary the driver no longer accepts is compiled again and
+// replaced.
+//
+// With hot reload on, edits to the shader sources are picked up while running:
+// reloadChanged() rebuilds the programs using an edited file, includes too, and
+// swaps them in between frames. Callers get the new program on their next
+// request. A program that no longer builds keeps its previous version.
+//
+// Like the other GL owners the destructor makes no GL calls, call release().
+class ShaderCache {
+public:
+    // Cache shared by every renderer
+    static ShaderCache& shared();
+    
+    // Program built from the two shaders with a "#define NAME" per entry (see
+    // ShaderUtils::createShaderProgram()), 0 if it fails to build
+    unsigned int getProgram(const std::string& vertexPath, const std::string& fragmentPath,
+                            const std::vector<std::string>& defines = {});
+    
+    // The permutation with a mask of ShaderUtils::Feature compiled in, the
+    // features' defines first and then any extra ones
+    unsigned int getProgram(const std::string& vertexPath, const std::string& fragmentPath, unsigned int features,
+                            const std::vector<std::string>& defines = {});
+    
+    // Where binaries are stored, SHADER_CACHE_DIR by default. Empty turns storing
+    // and loading them off.
+    void setBinaryDirectory(const std::string& directory) { m_binaryDirectory = directory; }
+    const std::string& getBinaryDirectory() const { return m_binaryDirectory; }
+    
+    // Watch the shader sources, SHADER_SOURCE_DIR, for edits. Programs are read
+    // from SHADER_DIR, the build's copy of them, so edited files are copied over
+    // as the copy_shaders build step would. False if the directory can't be watched.
+    bool setHotReload(bool enabled);
+    bool isHotReloadEnabled() const { return m_watcher.isWatching(); }
+    
+    // Rebuild the programs whose sources were edited since the last call and
+    // swap them in. Call between frames, no program may be in use by a pass.
+    // Returns the number of programs swapped.
+    size_t reloadChanged();
+    
+    const ShaderCacheStats& getStats() const { return m_stats; }
+    
+    // Delete every program, must be called while the context is alive
+    void release();
+    
+private:
+    ShaderCache();
+    
+    // A requested program and what it was built from
+    struct Entry {
+        unsigned int program = 0;   // 0 if it failed to build
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::vector<std::string> defines;
+        std::vector<std::string> dependencies; // The two shaders and the files they include
+    };
+    
+    // Compile a program, or restore it from its binary, filling in its dependencies
+    unsigned int build(const std::string& vertexPath, const std::string& fragmentPath,
+                       const std::vector<std::string>& defines, std::vector<std::string>& dependencies);
+    
+    // Binary file of a program from its final sources and the driver
+    std::string getBinaryPath(const std::string& vertexCode, const std::string& fragmentCode);
+    
+    // 0 if the file is missing, damaged or rejected by the driver
+    static unsigned int loadBinary(const std::string& path);
+    static bool storeBinary(unsigned int program, const std::string& path);
+    
+    // Whether the context can save and restore program binaries
+    static bool isBinarySupported();
+    
+    std::unordered_map<std::string, Entry> m_programs;
+    ShaderWatcher m_watcher;
+    std::string m_binaryDirectory;
+    std::string m_driver;   // GL renderer and version, read on first use
+    ShaderCacheStats m_stats;
+};
+
+} // namespace Zenith
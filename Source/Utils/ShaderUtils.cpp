@@ -1,29 +1,154 @@
 #include "ShaderUtils.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
 namespace ShaderUtils {
+    namespace {
+        // Defines have to follow the #version line, which must come first
+        std::string injectDefines(const std::string& code, const std::vector<std::string>& defines) {
+            if (defines.empty()) {
+                return code;
+            }
+
+            std::string block;
+            for (const std::string& define : defines) {
+                block += "#define " + define + "\n";
+            }
+
+            size_t version = code.find("#version");
+            if (version == std::string::npos) {
+                return block + code;
+            }
+            size_t lineEnd = code.find('\n', version);
+            if (lineEnd == std::string::npos) {
+                return code + "\n" + block;
+            }
+
+            // Put the line numbers back to the shader's own after the inserted lines.
+            // The #version line comes before any include, so it is in file 0.
+            size_t versionLine = std::count(code.begin(), code.begin() + lineEnd, '\n') + 1;
+            block += "#line " + std::to_string(versionLine + 1) + " 0\n";
+            return code.substr(0, lineEnd + 1) + block + code.substr(lineEnd + 1);
+        }
+
+        // Append a file to `code` with its #include lines replaced, see loadShaderSource()
+        bool expandIncludes(const std::string& path, std::string& code, std::vector<std::string>& included) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << "\n";
+                return false;
+            }
+            int fileIndex = static_cast<int>(included.size());
+            included.push_back(path);
+
+            size_t slash = path.find_last_of("/\\");
+            std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+            std::string line;
+            int lineNumber = 0;
+            while (std::getline(file, line)) {
+                lineNumber++;
+                size_t start = line.find_first_not_of(" \t");
+                if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+                    code += line + "\n";
+                    continue;
+                }
+
+                size_t open = line.find('"', start);
+                size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+                if (close == std::string::npos) {
+                    std::cerr << "ERROR::SHADER::BAD_INCLUDE: " << path << ": " << line << "\n";
+                    return false;
+                }
+
+                std::string includePath = directory + line.substr(open + 1, close - open - 1);
+                bool seen = false;
+                for (const std::string& previous : included) {
+                    seen = seen || previous == includePath;
+                }
+                if (seen) {
+                    continue;
+                }
+
+                // Driver messages give the line within the file and the file's index
+                // in `included`, so number the pasted lines as their own file and
+                // resume this file's numbering after them
+                code += "#line 1 " + std::to_string(included.size()) + "\n";
+                if (!expandIncludes(includePath, code, included)) {
+                    return false;
+                }
+                code += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+            }
+            return true;
+        }
+    }
+
+    std::vector<std::string> getFeatureDefines(unsigned int features) {
+        static const char* const kDefines[] = {
+            "ENABLE_SHADOWS", "ENABLE_AO", "ENABLE_FOG", "ENABLE_SPECULAR", "TEXTURE_ARRAY", "ALPHA_TEST"
+        };
+
+        std::vector<std::string> defines;
+        for (int bit = 0; bit < static_cast<int>(sizeof(kDefines) / sizeof(kDefines[0])); bit++) {
+            if (features & (1u << bit)) {
+                defines.push_back(kDefines[bit]);
+            }
+        }
+        return defines;
+    }
+
+    std::string getFeatureNames(unsigned int features) {
+        static const char* const kNames[] = { "SHADOWS", "AO", "FOG", "SPECULAR", "TEXTURE_ARRAY", "ALPHA_TEST" };
+
+        std::string names;
+        for (int bit = 0; bit < static_cast<int>(sizeof(kNames) / sizeof(kNames[0])); bit++) {
+            if (features & (1u << bit)) {
+                names += (names.empty() ? "" : "+") + std::string(kNames[bit]);
+            }
+        }
+        return names.empty() ? "NONE" : names;
+    }
+
     unsigned int createShaderProgram(const std::string& vertexPath, const std::string& fragmentPath) {
+        return createShaderProgram(vertexPath, fragmentPath, {});
+    }
+
+    unsigned int createShaderProgram(const std::string& vertexPath, const std::string& fragmentPath,
+                                     const std::vector<std::string>& defines) {
+        std::string vertexCode;
+        std::string fragmentCode;
+        if (!loadShaderSource(vertexPath, defines, vertexCode) || !loadShaderSource(fragmentPath, defines, fragmentCode)) {
+            return 0;
+        }
+        return linkShaderProgram(vertexCode, fragmentCode);
+    }
+
+    bool loadShaderSource(const std::string& path, const std::vector<std::string>& defines, std::string& source,
+                          std::vector<std::string>* dependencies) {
+        std::string code;
+        std::vector<std::string> included;
+        if (!expandIncludes(path, code, included)) {
+            return false;
+        }
+        source = injectDefines(code, defines);
+        if (dependencies) {
+            *dependencies = included;
+        }
+        return true;
+    }
+
+    unsigned int linkShaderProgram(const std::string& vertexCode, const std::string& fragmentCode, bool retrievable) {
         unsigned int vertexShader = 0;
         unsigned int fragmentShader = 0;
         unsigned int program = 0;
         int success;
         char infoLog[512];
 
-        // Load and compile vertex shader
-        std::ifstream vShaderFile(vertexPath);
-        if (!vShaderFile.is_open()) {
-            std::cerr << "ERROR::SHADER::VERTEX::FILE_NOT_SUCCESFULLY_READ: " << vertexPath << "\n";
-            return 0;
-        }
-        std::stringstream vShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        vShaderFile.close();
-        std::string vertexCode = vShaderStream.str();
+        // Compile vertex shader
         const char* vShaderCode = vertexCode.c_str();
-
         vertexShader = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexShader, 1, &vShaderCode, NULL);
         glCompileShader(vertexShader);
@@ -31,22 +156,12 @@ namespace ShaderUtils {
         if (!success) {
             glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
             std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-            return 0;
-        }
-
-        // Load and compile fragment shader
-        std::ifstream fShaderFile(fragmentPath);
-        if (!fShaderFile.is_open()) {
-            std::cerr << "ERROR::SHADER::FRAGMENT::FILE_NOT_SUCCESFULLY_READ: " << fragmentPath << "\n";
             glDeleteShader(vertexShader);
             return 0;
         }
-        std::stringstream fShaderStream;
-        fShaderStream << fShaderFile.rdbuf();
-        fShaderFile.close();
-        std::string fragmentCode = fShaderStream.str();
-        const char* fShaderCode = fragmentCode.c_str();
 
+        // Compile fragment shader
+        const char* fShaderCode = fragmentCode.c_str();
         fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentShader, 1, &fShaderCode, NULL);
         glCompileShader(fragmentShader);
@@ -55,6 +170,7 @@ namespace ShaderUtils {
             glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
             std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
             glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
             return 0;
         }
 
@@ -62,19 +178,21 @@ namespace ShaderUtils {
         program = glCreateProgram();
         glAttachShader(program, vertexShader);
         glAttachShader(program, fragmentShader);
+        if (retrievable) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
         glLinkProgram(program);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
         glGetProgramiv(program, GL_LINK_STATUS, &success);
         if (!success) {
             glGetProgramInfoLog(program, 512, NULL, infoLog);
             std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-            glDeleteShader(vertexShader);
-            glDeleteShader(fragmentShader);
+            glDeleteProgram(program);
             return 0;
         }
 
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-
         return program;
     }
 }
\ No newline at end of file
@@ -1,7 +1,45 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace ShaderUtils {
+    // Optional parts of the shaders, each compiled in with a #define. A mask of
+    // them names a permutation; renderers ask for the smallest one a pass needs
+    // instead of branching on uniforms at runtime.
+    enum Feature : unsigned int {
+        SHADOWS       = 1u << 0,    // ENABLE_SHADOWS: cascaded shadow map lookups with PCF
+        AO            = 1u << 1,    // ENABLE_AO: baked per-vertex ambient occlusion
+        FOG           = 1u << 2,    // ENABLE_FOG: distance fog
+        SPECULAR      = 1u << 3,    // ENABLE_SPECULAR: Phong highlights
+        TEXTURE_ARRAY = 1u << 4,    // TEXTURE_ARRAY: one texture array lookup per face instead of a sampler each
+        ALPHA_TEST    = 1u << 5     // ALPHA_TEST: discard see-through texels, loses early depth testing
+    };
+
+    // The #defines of a feature mask, in Feature order
+    std::vector<std::string> getFeatureDefines(unsigned int features);
+
+    // Feature names of a mask for logs and UI, like "SHADOWS+AO", "NONE" for 0
+    std::string getFeatureNames(unsigned int features);
+
     unsigned int createShaderProgram(const std::string& vertexPath, const std::string& fragmentPath);
-}
\ No newline at end of file
+
+    // Same, with a "#define NAME" line per entry inserted after each shader's #version
+    // line, so optional features can be compiled out (e.g. "ENABLE_SHADOWS")
+    unsigned int createShaderProgram(const std::string& vertexPath, const std::string& fragmentPath,
+                                     const std::vector<std::string>& defines);
+
+    // Read a shader file with the defines inserted, false if it or a file it
+    // includes can't be read. Lines of the form #include "name" are replaced by
+    // that file, found next to the one including it; each file is pasted once.
+    // `dependencies`, if given, receives the path and every included file.
+    // #line directives keep compiler messages pointing into the right file: the
+    // source string number is the file's index in `dependencies`, 0 for `path`.
+    bool loadShaderSource(const std::string& path, const std::vector<std::string>& defines, std::string& source,
+                          std::vector<std::string>* dependencies = nullptr);
+
+    // Compile and link a program from loaded sources, 0 on failure. With
+    // `retrievable` set the driver keeps the binary for glGetProgramBinary.
+    unsigned int linkShaderProgram(const std::string& vertexCode, const std::string& fragmentCode,
+                                   bool retrievable = false);
+}
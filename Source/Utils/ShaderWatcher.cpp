@@ -0,0 +1,130 @@
+#include "ShaderWatcher.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Zenith {
+
+ShaderWatcher::ShaderWatcher()
+#ifdef __linux__
+    : m_fd(-1)
+#endif
+{
+}
+
+ShaderWatcher::~ShaderWatcher() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool ShaderWatcher::watch(const std::string& directory) {
+    stop();
+
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        std::cerr << "Can't start watching shaders: inotify_init1 failed" << std::endl;
+        return false;
+    }
+
+    // Editors either write the file in place or write a new one and rename it over
+    if (inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "Can't watch shader directory: " << directory << std::endl;
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_directory = directory;
+    return true;
+}
+
+void ShaderWatcher::stop() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_directory.clear();
+}
+
+std::vector<std::string> ShaderWatcher::poll() {
+    std::vector<std::string> names;
+    if (m_fd < 0) {
+        return names;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(m_fd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0) {
+                std::string name(event->name);
+                if (std::find(names.begin(), names.end(), name) == names.end()) {
+                    names.push_back(name);
+                }
+            }
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+    return names;
+}
+
+#else
+
+bool ShaderWatcher::watch(const std::string& directory) {
+    stop();
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        std::cerr << "Can't watch shader directory: " << directory << std::endl;
+        return false;
+    }
+
+    // The first scan only records the times
+    m_directory = directory;
+    scan();
+    m_lastScan = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ShaderWatcher::stop() {
+    m_directory.clear();
+    m_writeTimes.clear();
+}
+
+std::vector<std::string> ShaderWatcher::poll() {
+    auto now = std::chrono::steady_clock::now();
+    if (m_directory.empty() || now - m_lastScan < std::chrono::milliseconds(500)) {
+        return {};
+    }
+    m_lastScan = now;
+    return scan();
+}
+
+std::vector<std::string> ShaderWatcher::scan() {
+    std::vector<std::string> names;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error)) {
+        if (!entry.is_regular_file(error)) {
+            continue;
+        }
+        std::string name = entry.path().filename().string();
+        std::filesystem::file_time_type time = entry.last_write_time(error);
+
+        auto it = m_writeTimes.find(name);
+        if (it == m_writeTimes.end() || it->second != time) {
+            names.push_back(name);
+            m_writeTimes[name] = time;
+        }
+    }
+    return names;
+}
+
+#endif
+
+} // namespace Zenith
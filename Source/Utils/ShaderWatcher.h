@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenith {
+
+// Reports files written in one directory, for reloading edited shaders. Uses
+// inotify on Linux, which sees a save as soon as the editor closes or renames
+// the file; elsewhere the directory's modification times are compared twice a
+// second. Subdirectories aren't watched.
+class ShaderWatcher {
+public:
+    ShaderWatcher();
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    // Start watching a directory instead of the current one, false if it can't be watched
+    bool watch(const std::string& directory);
+    void stop();
+
+    bool isWatching() const { return !m_directory.empty(); }
+    const std::string& getDirectory() const { return m_directory; }
+
+    // Names of the files written since the last call, each once. Never blocks.
+    std::vector<std::string> poll();
+
+private:
+    std::string m_directory;
+
+#ifdef __linux__
+    int m_fd;
+#else
+    // Modification times seen by the last scan
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+    std::chrono::steady_clock::time_point m_lastScan;
+
+    // Names of the files whose time changed, recording the new times
+    std::vector<std::string> scan();
+#endif
+};
+
+} // namespace Zenith
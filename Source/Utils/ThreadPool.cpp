@@ -0,0 +1,124 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace Zenith {
+
+namespace {
+
+// Set on the pool's workers, and on a caller while it runs its loop's jobs
+thread_local bool t_insideLoop = false;
+
+} // namespace
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_job(nullptr), m_count(0), m_grain(1), m_nextIndex(0), m_generation(0), m_openSlots(0),
+      m_busyWorkers(0), m_stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job, size_t grain,
+                             unsigned int maxThreads) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    size_t threadCount = std::min<size_t>(maxThreads > 0 ? maxThreads : getThreadCount(), getThreadCount());
+    threadCount = std::min(threadCount, (count + grain - 1) / grain);
+
+    std::unique_lock<std::mutex> loop(m_loopMutex, std::defer_lock);
+    if (threadCount <= 1 || t_insideLoop || !loop.try_lock()) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_grain = grain;
+        m_nextIndex = 0;
+        m_openSlots = static_cast<unsigned int>(threadCount - 1);
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    // The calling thread works too
+    t_insideLoop = true;
+    work();
+    t_insideLoop = false;
+
+    // Every index is taken; workers that haven't joined yet aren't needed
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_openSlots = 0;
+    m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    t_insideLoop = true;
+
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this, &seen]() { return m_stopping || m_generation != seen; });
+        if (m_stopping) {
+            return;
+        }
+        seen = m_generation;
+        if (m_openSlots == 0) {
+            continue;
+        }
+        m_openSlots--;
+        m_busyWorkers++;
+
+        lock.unlock();
+        work();
+        lock.lock();
+
+        if (--m_busyWorkers == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::work() {
+    while (true) {
+        size_t begin = m_nextIndex.fetch_add(m_grain);
+        if (begin >= m_count) {
+            break;
+        }
+        size_t end = std::min(begin + m_grain, m_count);
+        for (size_t i = begin; i < end; i++) {
+            (*m_job)(i);
+        }
+    }
+}
+
+} // namespace Zenith
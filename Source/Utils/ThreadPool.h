@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Zenith {
+
+// Worker threads started once and reused by every parallel loop, so a loop
+// costs a wake-up instead of creating and joining threads each time.
+//
+// One loop runs at a time. A loop started from inside another loop's job, or
+// while another thread's loop is running, runs on the calling thread alone
+// instead of waiting, so nested and concurrent callers can't deadlock.
+class ThreadPool {
+public:
+    // Pool shared by the light engine and the model generators, one thread per core
+    static ThreadPool& shared();
+
+    // threadCount 0 uses std::thread::hardware_concurrency(). The calling thread
+    // works too, so threadCount - 1 workers are started.
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads a loop can use, the caller included
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+    // Run job(i) for every i in [0, count), handing out `grain` indices at a time,
+    // on at most maxThreads threads (0 for all of them). Returns once every job
+    // has finished.
+    void parallelFor(size_t count, const std::function<void(size_t)>& job, size_t grain = 1,
+                     unsigned int maxThreads = 0);
+
+private:
+    void workerLoop();
+
+    // Run indices of the current loop until none are left
+    void work();
+
+    std::vector<std::thread> m_workers;
+
+    // Held by the thread running a loop
+    std::mutex m_loopMutex;
+
+    // The current loop, written under m_mutex before m_generation changes
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t)>* m_job;
+    size_t m_count;
+    size_t m_grain;
+    std::atomic<size_t> m_nextIndex;
+    uint64_t m_generation;      // Bumped for every loop, workers join each one at most once
+    unsigned int m_openSlots;   // Workers still wanted by the current loop
+    unsigned int m_busyWorkers; // Workers inside the current loop
+    bool m_stopping;
+};
+
+} // namespace Zenith
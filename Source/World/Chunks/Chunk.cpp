@@ -0,0 +1,55 @@
+#include "Chunk.h"
+
+namespace Zenith {
+
+Chunk::Chunk(const glm::ivec3& coord)
+    : m_coord(coord), m_blockCount(0), m_uniformLight(CHUNK_FULL_SKY_LIGHT),
+      m_dirty(false), m_translucentSortCell(0), m_translucentSorted(false),
+      m_lodLevel(0), m_staleLods(0), m_faceConnectivity(0x7FFF)
+{
+    // Every face pair connected until the chunk is meshed
+}
+
+uint16_t Chunk::setBlock(int x, int y, int z, uint16_t blockId) {
+    if (m_blocks.empty()) {
+        if (blockId == 0) {
+            return 0;
+        }
+        m_blocks.assign(CHUNK_VOLUME, 0);
+    }
+    
+    uint16_t& cell = m_blocks[index(x, y, z)];
+    uint16_t previous = cell;
+    cell = blockId;
+    
+    if (previous == 0 && blockId != 0) {
+        m_blockCount++;
+    } else if (previous != 0 && blockId == 0) {
+        m_blockCount--;
+    }
+    
+    return previous;
+}
+
+void Chunk::setLight(int cell, uint8_t light) {
+    if (m_light.empty()) {
+        if (light == m_uniformLight) {
+            return;
+        }
+        m_light.assign(CHUNK_VOLUME, m_uniformLight);
+    }
+    m_light[cell] = light;
+}
+
+void Chunk::fillLight(uint8_t light) {
+    m_light.clear();
+    m_light.shrink_to_fit();
+    m_uniformLight = light;
+}
+
+void Chunk::clear() {
+    m_blocks.clear();
+    m_blockCount = 0;
+}
+
+} // namespace Zenith
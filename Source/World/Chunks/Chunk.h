@@ -0,0 +1,141 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ChunkMesh.h"
+
+namespace Zenith {
+
+// Edge length of a chunk in voxels
+constexpr int CHUNK_SIZE = 16;
+constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// Cell light packs sky light in the high nibble and block light in the low one,
+// 0..15 each. Cells open to the sky with no light source nearby hold this.
+constexpr uint8_t CHUNK_FULL_SKY_LIGHT = 0xF0;
+
+// Detail levels meshed per chunk: full resolution, then 2x, 4x and 8x downsampled
+constexpr int CHUNK_LOD_COUNT = 4;
+
+// A CHUNK_SIZE^3 section of a model. Blocks are stored as palette indices owned by
+// the model (0 = empty) and the chunk keeps its own mesh, so an edit only has to
+// remesh the chunks it touches.
+class Chunk {
+public:
+    // Constructor: coord is the chunk's position in the model's chunk grid
+    explicit Chunk(const glm::ivec3& coord);
+    
+    // Get the palette index at a local position (0 if empty)
+    uint16_t getBlock(int x, int y, int z) const {
+        return m_blocks.empty() ? 0 : m_blocks[index(x, y, z)];
+    }
+    
+    // Same by linear index (see index())
+    uint16_t getBlock(int cell) const {
+        return m_blocks.empty() ? 0 : m_blocks[cell];
+    }
+    
+    // Set the palette index at a local position, returns the previous index
+    uint16_t setBlock(int x, int y, int z, uint16_t blockId);
+    
+    // Remove all blocks (the mesh is kept until the chunk is rebuilt)
+    void clear();
+    
+    // Number of non-empty cells
+    int getBlockCount() const { return m_blockCount; }
+    bool isEmpty() const { return m_blockCount == 0; }
+    
+    // Dirty chunks have changed since their mesh was last built
+    bool isDirty() const { return m_dirty; }
+    void setDirty(bool dirty) { m_dirty = dirty; }
+    
+    // Position in the chunk grid and the voxel offset of the chunk inside its model
+    const glm::ivec3& getCoord() const { return m_coord; }
+    glm::ivec3 getOrigin() const { return m_coord * CHUNK_SIZE; }
+    
+    // GPU mesh of the chunk at a detail level (0 = full resolution)
+    ChunkMesh& getMesh(int lod = 0) { return m_meshes[lod]; }
+    const ChunkMesh& getMesh(int lod = 0) const { return m_meshes[lod]; }
+    
+    // Alpha tested faces (fancy leaves) at full resolution, drawn after the opaque
+    // pass with the discarding program. Coarse levels keep them in their one mesh.
+    ChunkMesh& getCutoutMesh() { return m_cutoutMesh; }
+    const ChunkMesh& getCutoutMesh() const { return m_cutoutMesh; }
+    
+    // Translucent faces at full resolution, blended after the opaque pass (coarse
+    // levels keep them in their one mesh). The CPU copy is kept so the faces can
+    // be re-sorted as the camera moves.
+    ChunkMesh& getTranslucentMesh() { return m_translucentMesh; }
+    const ChunkMesh& getTranslucentMesh() const { return m_translucentMesh; }
+    ChunkMeshData& getTranslucentData() { return m_translucentData; }
+    
+    // Whether the translucent faces are sorted for a camera in `cell` (chunk local
+    // block coordinates). Remeshing invalidates the order.
+    bool isTranslucentSortedFor(const glm::ivec3& cell) const {
+        return m_translucentSorted && m_translucentSortCell == cell;
+    }
+    void setTranslucentSortCell(const glm::ivec3& cell) {
+        m_translucentSortCell = cell;
+        m_translucentSorted = true;
+    }
+    void invalidateTranslucentSort() { m_translucentSorted = false; }
+    
+    // Detail level the chunk is currently drawn at
+    int getLodLevel() const { return m_lodLevel; }
+    void setLodLevel(int lod) { m_lodLevel = lod; }
+    
+    // Coarse meshes are only rebuilt when a stale level is about to be drawn
+    bool isLodStale(int lod) const { return (m_staleLods & (1u << lod)) != 0; }
+    void setLodStale(int lod, bool stale) {
+        m_staleLods = stale ? (m_staleLods | (1u << lod)) : (m_staleLods & ~(1u << lod));
+    }
+    
+    // Which pairs of chunk faces are linked through non-opaque cells, see
+    // ChunkVisibilityGraph. Set when the chunk is meshed.
+    uint16_t getFaceConnectivity() const { return m_faceConnectivity; }
+    void setFaceConnectivity(uint16_t connectivity) { m_faceConnectivity = connectivity; }
+    
+    // Packed sky and block light of a cell by linear index, see ChunkLightEngine
+    uint8_t getLight(int cell) const {
+        return m_light.empty() ? m_uniformLight : m_light[cell];
+    }
+    uint8_t getLight(int x, int y, int z) const { return getLight(index(x, y, z)); }
+    void setLight(int cell, uint8_t light);
+    
+    // Give every cell the same light, freeing the per-cell storage
+    void fillLight(uint8_t light);
+    
+    // Linear index of a local position
+    static int index(int x, int y, int z) {
+        return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x;
+    }
+    
+private:
+    glm::ivec3 m_coord;
+    
+    // Palette indices, only allocated once the first block is set
+    std::vector<uint16_t> m_blocks;
+    int m_blockCount;
+    
+    // Packed light per cell, empty while every cell holds m_uniformLight
+    std::vector<uint8_t> m_light;
+    uint8_t m_uniformLight;
+    
+    bool m_dirty;
+    std::array<ChunkMesh, CHUNK_LOD_COUNT> m_meshes;
+    ChunkMesh m_cutoutMesh;
+    ChunkMesh m_translucentMesh;
+    ChunkMeshData m_translucentData;
+    glm::ivec3 m_translucentSortCell;
+    bool m_translucentSorted;
+    int m_lodLevel;
+    unsigned int m_staleLods;
+    uint16_t m_faceConnectivity;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_H
@@ -0,0 +1,312 @@
+#include "ChunkBufferPool.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+namespace Zenith {
+
+ChunkBufferPool& ChunkBufferPool::shared() {
+    static ChunkBufferPool pool;
+    return pool;
+}
+
+ChunkBufferPool::ChunkBufferPool()
+    : m_uploadedThisFrame(0), m_bytesMoved(0)
+{
+}
+
+bool ChunkBufferPool::takeFromPage(int pageIndex, size_t bytes, size_t& offset) {
+    Page& page = m_pages[pageIndex];
+    
+    // First fit, chunk meshes are similar in size
+    for (size_t i = 0; i < page.freeBlocks.size(); i++) {
+        FreeBlock& block = page.freeBlocks[i];
+        if (block.size < bytes) {
+            continue;
+        }
+        
+        offset = block.offset;
+        block.offset += bytes;
+        block.size -= bytes;
+        if (block.size == 0) {
+            page.freeBlocks.erase(page.freeBlocks.begin() + i);
+        }
+        return true;
+    }
+    
+    return false;
+}
+
+bool ChunkBufferPool::allocate(ChunkBufferAllocation& allocation, size_t bytes) {
+    free(allocation);
+    if (bytes == 0) {
+        return false;
+    }
+    
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    
+    int pageIndex = -1;
+    size_t offset = 0;
+    for (size_t i = 0; i < m_pages.size() && pageIndex < 0; i++) {
+        if (takeFromPage(static_cast<int>(i), bytes, offset)) {
+            pageIndex = static_cast<int>(i);
+        }
+    }
+    
+    // No room anywhere, start a new page (bigger than usual for an oversized request)
+    if (pageIndex < 0) {
+        Page page;
+        page.size = std::max(PAGE_BYTES, bytes);
+        glGenBuffers(1, &page.buffer);
+        if (page.buffer == 0) {
+            std::cerr << "Error: Could not create a chunk buffer page" << std::endl;
+            return false;
+        }
+        
+        // Immutable storage lets the driver place the page once; contents still change
+        // through glBufferSubData
+        glBindBuffer(GL_ARRAY_BUFFER, page.buffer);
+        if (GLAD_GL_VERSION_4_4) {
+            glBufferStorage(GL_ARRAY_BUFFER, page.size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, page.size, nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        
+        page.freeBlocks.push_back({ 0, page.size });
+        m_pages.push_back(std::move(page));
+        
+        pageIndex = static_cast<int>(m_pages.size() - 1);
+        takeFromPage(pageIndex, bytes, offset);
+    }
+    
+    Page& page = m_pages[pageIndex];
+    page.usedBytes += bytes;
+    page.allocations.insert(&allocation);
+    
+    allocation.page = pageIndex;
+    allocation.offset = offset;
+    allocation.size = bytes;
+    return true;
+}
+
+void ChunkBufferPool::free(ChunkBufferAllocation& allocation) {
+    if (allocation.isValid() && allocation.page < static_cast<int>(m_pages.size())) {
+        Page& page = m_pages[allocation.page];
+        if (page.allocations.erase(&allocation) > 0) {
+            page.usedBytes -= allocation.size;
+            
+            // The GPU may still be drawing from it, wait for this frame's fence
+            m_freedThisFrame.push_back(allocation);
+        }
+    }
+    
+    allocation = ChunkBufferAllocation();
+}
+
+void ChunkBufferPool::returnToPage(const ChunkBufferAllocation& range) {
+    if (range.page >= static_cast<int>(m_pages.size())) {
+        return;
+    }
+    Page& page = m_pages[range.page];
+    
+    // Insert in offset order, then merge with the neighbours it touches
+    auto it = std::lower_bound(page.freeBlocks.begin(), page.freeBlocks.end(), range.offset,
+                               [](const FreeBlock& block, size_t offset) { return block.offset < offset; });
+    it = page.freeBlocks.insert(it, { range.offset, range.size });
+    
+    auto next = it + 1;
+    if (next != page.freeBlocks.end() && it->offset + it->size == next->offset) {
+        it->size += next->size;
+        page.freeBlocks.erase(next);
+    }
+    if (it != page.freeBlocks.begin()) {
+        auto previous = it - 1;
+        if (previous->offset + previous->size == it->offset) {
+            previous->size += it->size;
+            page.freeBlocks.erase(it);
+        }
+    }
+}
+
+void ChunkBufferPool::upload(const ChunkBufferAllocation& allocation, const void* data, size_t bytes) {
+    if (!allocation.isValid() || bytes > allocation.size) {
+        return;
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, m_pages[allocation.page].buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, bytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_uploadedThisFrame += bytes;
+}
+
+void ChunkBufferPool::endFrame() {
+    // Fences pass in order, so stop at the first one still pending
+    while (!m_pendingFrees.empty()) {
+        GLsync fence = static_cast<GLsync>(m_pendingFrees.front().fence);
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        
+        for (const ChunkBufferAllocation& range : m_pendingFrees.front().ranges) {
+            returnToPage(range);
+        }
+        glDeleteSync(fence);
+        m_pendingFrees.pop_front();
+    }
+    
+    // Only compact when nothing is streaming in, so it never competes with remeshing
+    if (m_uploadedThisFrame == 0) {
+        defragment(DEFRAG_BYTES_PER_FRAME);
+    }
+    m_uploadedThisFrame = 0;
+    
+    if (!m_freedThisFrame.empty()) {
+        PendingFrees pending;
+        pending.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pending.ranges.swap(m_freedThisFrame);
+        m_pendingFrees.push_back(std::move(pending));
+    }
+}
+
+void ChunkBufferPool::defragment(size_t budget) {
+    // The page split into the most free blocks gains the most
+    int pageIndex = -1;
+    size_t mostBlocks = 1;
+    for (size_t i = 0; i < m_pages.size(); i++) {
+        if (m_pages[i].freeBlocks.size() > mostBlocks) {
+            mostBlocks = m_pages[i].freeBlocks.size();
+            pageIndex = static_cast<int>(i);
+        }
+    }
+    if (pageIndex < 0) {
+        return;
+    }
+    Page& page = m_pages[pageIndex];
+    
+    // Candidates from the top of the page down. A range too big for every hole
+    // below it doesn't end the pass, a smaller one under it may still fit.
+    std::vector<ChunkBufferAllocation*> candidates(page.allocations.begin(), page.allocations.end());
+    std::sort(candidates.begin(), candidates.end(), [](const ChunkBufferAllocation* a, const ChunkBufferAllocation* b) {
+        return a->offset > b->offset;
+    });
+    
+    bool copied = false;
+    for (ChunkBufferAllocation* candidate : candidates) {
+        // No hole left below this range, so none below any of the rest either
+        if (budget == 0 || page.freeBlocks.empty() || page.freeBlocks.front().offset > candidate->offset) {
+            break;
+        }
+        if (candidate->size > budget) {
+            continue;
+        }
+        
+        // Lowest hole below it that can hold it
+        auto hole = std::find_if(page.freeBlocks.begin(), page.freeBlocks.end(), [candidate](const FreeBlock& block) {
+            return block.offset < candidate->offset && block.size >= candidate->size;
+        });
+        if (hole == page.freeBlocks.end()) {
+            continue;
+        }
+        
+        size_t newOffset = hole->offset;
+        hole->offset += candidate->size;
+        hole->size -= candidate->size;
+        if (hole->size == 0) {
+            page.freeBlocks.erase(hole);
+        }
+        
+        if (!copied) {
+            glBindBuffer(GL_COPY_READ_BUFFER, page.buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+            copied = true;
+        }
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, candidate->offset, newOffset, candidate->size);
+        
+        // Earlier draws may still read the old range, it goes through the fence like any free
+        m_freedThisFrame.push_back(*candidate);
+        candidate->offset = newOffset;
+        
+        budget -= candidate->size;
+        m_bytesMoved += candidate->size;
+    }
+    
+    if (copied) {
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
+
+size_t ChunkBufferPool::getUsedBytes() const {
+    size_t used = 0;
+    for (const Page& page : m_pages) {
+        used += page.usedBytes;
+    }
+    return used;
+}
+
+size_t ChunkBufferPool::getCapacityBytes() const {
+    size_t capacity = 0;
+    for (const Page& page : m_pages) {
+        capacity += page.size;
+    }
+    return capacity;
+}
+
+ChunkBufferPoolStats ChunkBufferPool::getStats() const {
+    ChunkBufferPoolStats stats;
+    stats.pages = m_pages.size();
+    stats.bytesMoved = m_bytesMoved;
+    
+    // The weighted average of the pages' fragmentation reduces to the sum of
+    // their largest blocks over the free bytes
+    size_t pageLargestBlocks = 0;
+    for (const Page& page : m_pages) {
+        stats.capacityBytes += page.size;
+        stats.usedBytes += page.usedBytes;
+        stats.freeBlocks += page.freeBlocks.size();
+        size_t pageLargest = 0;
+        for (const FreeBlock& block : page.freeBlocks) {
+            stats.freeBytes += block.size;
+            pageLargest = std::max(pageLargest, block.size);
+        }
+        stats.largestFreeBlock = std::max(stats.largestFreeBlock, pageLargest);
+        pageLargestBlocks += pageLargest;
+    }
+    
+    for (const ChunkBufferAllocation& range : m_freedThisFrame) {
+        stats.pendingFreeBytes += range.size;
+    }
+    for (const PendingFrees& pending : m_pendingFrees) {
+        for (const ChunkBufferAllocation& range : pending.ranges) {
+            stats.pendingFreeBytes += range.size;
+        }
+    }
+    
+    if (stats.freeBytes > 0) {
+        stats.fragmentation = 1.0f - static_cast<float>(pageLargestBlocks) / stats.freeBytes;
+    }
+    return stats;
+}
+
+void ChunkBufferPool::release() {
+    for (PendingFrees& pending : m_pendingFrees) {
+        glDeleteSync(static_cast<GLsync>(pending.fence));
+    }
+    m_pendingFrees.clear();
+    m_freedThisFrame.clear();
+    
+    // Live allocations are forgotten, their owners see them as invalid
+    for (Page& page : m_pages) {
+        for (ChunkBufferAllocation* allocation : page.allocations) {
+            *allocation = ChunkBufferAllocation();
+        }
+        if (page.buffer != 0) {
+            glDeleteBuffers(1, &page.buffer);
+        }
+    }
+    m_pages.clear();
+}
+
+} // namespace Zenith
@@ -0,0 +1,125 @@
+#ifndef CHUNK_BUFFER_POOL_H
+#define CHUNK_BUFFER_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+namespace Zenith {
+
+// A range of one of the pool's buffers
+struct ChunkBufferAllocation {
+    int page = -1;
+    size_t offset = 0;      // In bytes, a multiple of ChunkBufferPool::ALIGNMENT
+    size_t size = 0;
+    
+    bool isValid() const { return page >= 0; }
+};
+
+// Memory counters for the stats window
+struct ChunkBufferPoolStats {
+    size_t pages = 0;
+    size_t capacityBytes = 0;
+    size_t usedBytes = 0;
+    size_t freeBytes = 0;           // Ready to be reused
+    size_t pendingFreeBytes = 0;    // Released but maybe still read by the GPU
+    size_t freeBlocks = 0;
+    size_t largestFreeBlock = 0;
+    // Per page 1 - largest free block / free bytes, averaged weighted by each
+    // page's free bytes. Per page since no allocation can span two pages.
+    float fragmentation = 0.0f;
+    size_t bytesMoved = 0;          // By defragmentation, since startup
+};
+
+// Chunk meshes sub-allocated from a few large GL buffers, so every chunk in a page
+// can be drawn with one multi-draw call. Pages are used as vertex buffers or shader
+// storage buffers depending on the mesh layout, and are immutable (glBufferStorage)
+// where GL 4.4 is available.
+//
+// Ranges are handed out first fit from a free list per page. A released range only
+// returns to the free list once a fence placed at the end of the frame that released
+// it has passed, so the GPU never reads a range that was already reused. Frames
+// without uploads compact the pages a little by moving the highest ranges down.
+class ChunkBufferPool {
+public:
+    static constexpr size_t PAGE_BYTES = 32 * 1024 * 1024;
+    
+    // Both ChunkVertex and ChunkFace are 8 bytes, so offsets double as element indices
+    static constexpr size_t ALIGNMENT = 8;
+    
+    // Most bytes moved by defragmentation in one idle frame
+    static constexpr size_t DEFRAG_BYTES_PER_FRAME = 1024 * 1024;
+    
+    // Pool shared by every chunk mesh
+    static ChunkBufferPool& shared();
+    
+    // Reserve `bytes` in the first page with room, adding a page if none has.
+    // The pool keeps a pointer to `allocation` and updates it when defragmentation
+    // moves the range, so it must stay at the same address until freed.
+    // Needs a current GL context when a page is added.
+    bool allocate(ChunkBufferAllocation& allocation, size_t bytes);
+    
+    // Release a range and reset `allocation`. Only touches the pool's lists, so it
+    // is safe without a context (mesh destructors call it).
+    void free(ChunkBufferAllocation& allocation);
+    
+    // Copy data to the start of an allocation
+    void upload(const ChunkBufferAllocation& allocation, const void* data, size_t bytes);
+    
+    // Call once per frame after the last draw: fences this frame's frees, recycles
+    // ranges whose fences passed and defragments if nothing was uploaded
+    void endFrame();
+    
+    size_t getPageCount() const { return m_pages.size(); }
+    unsigned int getBuffer(int page) const { return m_pages[page].buffer; }
+    
+    size_t getUsedBytes() const;
+    size_t getCapacityBytes() const;
+    ChunkBufferPoolStats getStats() const;
+    
+    // Delete every page, must be called while the context is alive
+    void release();
+    
+private:
+    ChunkBufferPool();
+    
+    struct FreeBlock {
+        size_t offset;
+        size_t size;
+    };
+    
+    struct Page {
+        unsigned int buffer = 0;
+        size_t size = 0;
+        size_t usedBytes = 0;
+        std::vector<FreeBlock> freeBlocks;  // Sorted by offset, neighbours merged
+        std::unordered_set<ChunkBufferAllocation*> allocations;
+    };
+    
+    // Ranges released in one frame, waiting on that frame's fence
+    struct PendingFrees {
+        void* fence;                        // GLsync
+        std::vector<ChunkBufferAllocation> ranges;
+    };
+    
+    // Take `bytes` from a page's free list, returns false if no block fits
+    bool takeFromPage(int pageIndex, size_t bytes, size_t& offset);
+    
+    // Put a range back on its page's free list
+    void returnToPage(const ChunkBufferAllocation& range);
+    
+    // Move live ranges of the most fragmented page towards its start, highest first,
+    // each into the lowest hole below it that holds it
+    void defragment(size_t budget);
+    
+    std::vector<Page> m_pages;
+    std::vector<ChunkBufferAllocation> m_freedThisFrame;
+    std::deque<PendingFrees> m_pendingFrees;
+    size_t m_uploadedThisFrame;
+    size_t m_bytesMoved;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_BUFFER_POOL_H
@@ -0,0 +1,284 @@
+#include "ChunkDrawBatcher.h"
+#include "ChunkBufferPool.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace Zenith {
+
+namespace {
+
+// Layouts of the commands read by glMultiDrawElementsIndirect / glMultiDrawArraysIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+struct DrawArraysIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t first;
+    uint32_t baseInstance;
+};
+
+const GLuint kChunkOriginLocation = 7;
+
+// Face records are read from the page as a storage buffer. Fetching them as vertices
+// would run past the page (six vertices per record), so the attribute is turned off.
+void enableVertexArray(bool enabled) {
+    if (enabled) {
+        glEnableVertexAttribArray(0);
+    } else {
+        glDisableVertexAttribArray(0);
+    }
+}
+
+} // namespace
+
+ChunkDrawBatcher& ChunkDrawBatcher::shared() {
+    static ChunkDrawBatcher batcher;
+    return batcher;
+}
+
+ChunkDrawBatcher::ChunkDrawBatcher()
+    : m_originBuffer(0), m_indirectBuffer(0), m_originCapacity(0), m_indirectCapacity(0),
+      m_multiDrawEnabled(true)
+{
+}
+
+bool ChunkDrawBatcher::isMultiDrawSupported() {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void ChunkDrawBatcher::add(const ChunkMesh& mesh, const glm::vec3& origin) {
+    if (!mesh.isEmpty() && mesh.getAllocation().isValid()) {
+        m_draws.push_back({ &mesh, origin });
+    }
+}
+
+size_t ChunkDrawBatcher::submit(ChunkMeshLayout layout, bool keepOrder) {
+    if (m_draws.empty()) {
+        return 0;
+    }
+    
+    // One group per page, so each multi-draw reads a single buffer. Pages go in the
+    // order their first draw was queued and keep their draws' order, so a queue
+    // sorted nearest first stays roughly that way.
+    if (!keepOrder) {
+        int lastPage = 0;
+        for (const QueuedDraw& draw : m_draws) {
+            lastPage = std::max(lastPage, draw.mesh->getAllocation().page);
+        }
+        m_pageRanks.assign(static_cast<size_t>(lastPage) + 1, SIZE_MAX);
+        size_t rank = 0;
+        for (const QueuedDraw& draw : m_draws) {
+            size_t& pageRank = m_pageRanks[draw.mesh->getAllocation().page];
+            if (pageRank == SIZE_MAX) {
+                pageRank = rank++;
+            }
+        }
+        std::stable_sort(m_draws.begin(), m_draws.end(), [this](const QueuedDraw& a, const QueuedDraw& b) {
+            return m_pageRanks[a.mesh->getAllocation().page] < m_pageRanks[b.mesh->getAllocation().page];
+        });
+    }
+    
+    size_t drawCalls = (m_multiDrawEnabled && isMultiDrawSupported()) ? submitMultiDraw(layout) : submitLoop(layout);
+    
+    glBindVertexArray(0);
+    m_draws.clear();
+    return drawCalls;
+}
+
+size_t ChunkDrawBatcher::submitMultiDraw(ChunkMeshLayout layout) {
+    bool faces = layout == ChunkMeshLayout::FACE_RECORDS;
+    
+    // Commands for every page go in one buffer; baseInstance picks each draw's origin
+    struct Group {
+        int page;
+        size_t firstCommand;
+        size_t commandCount;
+    };
+    std::vector<Group> groups;
+    
+    m_origins.clear();
+    m_commands.clear();
+    
+    for (const QueuedDraw& draw : m_draws) {
+        const ChunkMesh& mesh = *draw.mesh;
+        if (mesh.getLayout() != layout) {
+            continue;
+        }
+        
+        int page = mesh.getAllocation().page;
+        if (groups.empty() || groups.back().page != page) {
+            size_t commandSize = faces ? sizeof(DrawArraysIndirectCommand) : sizeof(DrawElementsIndirectCommand);
+            groups.push_back({ page, m_commands.size() * sizeof(uint32_t) / commandSize, 0 });
+        }
+        
+        uint32_t baseInstance = static_cast<uint32_t>(m_origins.size());
+        m_origins.push_back(draw.origin);
+        
+        if (faces) {
+            DrawArraysIndirectCommand command = {
+                static_cast<uint32_t>(mesh.getFaceCount() * 6), 1,
+                static_cast<uint32_t>(mesh.getBaseElement() * 6), baseInstance
+            };
+            const uint32_t* words = reinterpret_cast<const uint32_t*>(&command);
+            m_commands.insert(m_commands.end(), words, words + sizeof(command) / sizeof(uint32_t));
+        } else {
+            DrawElementsIndirectCommand command = {
+                static_cast<uint32_t>(mesh.getIndexCount()), 1, 0,
+                static_cast<int32_t>(mesh.getBaseElement()), baseInstance
+            };
+            const uint32_t* words = reinterpret_cast<const uint32_t*>(&command);
+            m_commands.insert(m_commands.end(), words, words + sizeof(command) / sizeof(uint32_t));
+        }
+        groups.back().commandCount++;
+    }
+    
+    if (groups.empty()) {
+        return 0;
+    }
+    
+    if (m_indirectBuffer == 0) {
+        glGenBuffers(1, &m_indirectBuffer);
+    }
+    
+    // Page VAOs point aChunkOrigin at the origin buffer, so create it first
+    for (const Group& group : groups) {
+        getPageVertexArray(group.page);
+    }
+    uploadStream(GL_ARRAY_BUFFER, m_originBuffer, m_originCapacity,
+                 m_origins.data(), m_origins.size() * sizeof(glm::vec3));
+    uploadStream(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer, m_indirectCapacity,
+                 m_commands.data(), m_commands.size() * sizeof(uint32_t));
+    
+    ChunkBufferPool& pool = ChunkBufferPool::shared();
+    for (const Group& group : groups) {
+        glBindVertexArray(getPageVertexArray(group.page));
+        glEnableVertexAttribArray(kChunkOriginLocation);
+        enableVertexArray(!faces);
+        
+        if (faces) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pool.getBuffer(group.page));
+            glMultiDrawArraysIndirect(GL_TRIANGLES, (void*)(group.firstCommand * sizeof(DrawArraysIndirectCommand)),
+                                      static_cast<GLsizei>(group.commandCount), 0);
+        } else {
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                        (void*)(group.firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                        static_cast<GLsizei>(group.commandCount), 0);
+        }
+    }
+    
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    return groups.size();
+}
+
+size_t ChunkDrawBatcher::submitLoop(ChunkMeshLayout layout) {
+    ChunkBufferPool& pool = ChunkBufferPool::shared();
+    size_t drawCalls = 0;
+    int boundPage = -1;
+    
+    for (const QueuedDraw& draw : m_draws) {
+        const ChunkMesh& mesh = *draw.mesh;
+        if (mesh.getLayout() != layout) {
+            continue;
+        }
+        
+        int page = mesh.getAllocation().page;
+        if (page != boundPage) {
+            glBindVertexArray(getPageVertexArray(page));
+            
+            // With the array off, aChunkOrigin takes the value set below for each draw
+            glDisableVertexAttribArray(kChunkOriginLocation);
+            enableVertexArray(layout == ChunkMeshLayout::QUAD_VERTICES);
+            if (layout == ChunkMeshLayout::FACE_RECORDS) {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pool.getBuffer(page));
+            }
+            boundPage = page;
+        }
+        
+        glVertexAttrib3f(kChunkOriginLocation, draw.origin.x, draw.origin.y, draw.origin.z);
+        if (layout == ChunkMeshLayout::FACE_RECORDS) {
+            glDrawArrays(GL_TRIANGLES, static_cast<GLint>(mesh.getBaseElement() * 6),
+                         static_cast<GLsizei>(mesh.getFaceCount() * 6));
+        } else {
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(mesh.getIndexCount()), GL_UNSIGNED_INT,
+                                     (void*)0, static_cast<GLint>(mesh.getBaseElement()));
+        }
+        drawCalls++;
+    }
+    
+    return drawCalls;
+}
+
+unsigned int ChunkDrawBatcher::getPageVertexArray(int page) {
+    if (page < static_cast<int>(m_pageVAOs.size()) && m_pageVAOs[page] != 0) {
+        return m_pageVAOs[page];
+    }
+    
+    if (page >= static_cast<int>(m_pageVAOs.size())) {
+        m_pageVAOs.resize(page + 1, 0);
+    }
+    if (m_originBuffer == 0) {
+        glGenBuffers(1, &m_originBuffer);
+    }
+    
+    // Created before the VAO is bound so it doesn't end up in another VAO
+    unsigned int quadIndices = ChunkMesh::getQuadIndexBuffer();
+    
+    unsigned int vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices);
+    
+    // Vertices from the start of the page, draws add their base vertex
+    glBindBuffer(GL_ARRAY_BUFFER, ChunkBufferPool::shared().getBuffer(page));
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    
+    // One origin per draw, selected by the command's baseInstance
+    glBindBuffer(GL_ARRAY_BUFFER, m_originBuffer);
+    glVertexAttribPointer(kChunkOriginLocation, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glVertexAttribDivisor(kChunkOriginLocation, 1);
+    
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    m_pageVAOs[page] = vao;
+    return vao;
+}
+
+void ChunkDrawBatcher::uploadStream(unsigned int target, unsigned int buffer, size_t& capacity,
+                                    const void* data, size_t bytes) {
+    glBindBuffer(target, buffer);
+    
+    // Orphan every frame so the driver doesn't wait on last frame's draws
+    capacity = std::max(capacity, bytes);
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, bytes, data);
+}
+
+void ChunkDrawBatcher::release() {
+    for (unsigned int& vao : m_pageVAOs) {
+        if (vao != 0) {
+            glDeleteVertexArrays(1, &vao);
+        }
+    }
+    m_pageVAOs.clear();
+    
+    if (m_originBuffer != 0) {
+        glDeleteBuffers(1, &m_originBuffer);
+    }
+    if (m_indirectBuffer != 0) {
+        glDeleteBuffers(1, &m_indirectBuffer);
+    }
+    m_originBuffer = m_indirectBuffer = 0;
+    m_originCapacity = m_indirectCapacity = 0;
+    m_draws.clear();
+}
+
+} // namespace Zenith
@@ -0,0 +1,74 @@
+#ifndef CHUNK_DRAW_BATCHER_H
+#define CHUNK_DRAW_BATCHER_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ChunkMesh.h"
+
+namespace Zenith {
+
+// Collects the visible chunk meshes of a frame and draws them with one
+// glMultiDraw*Indirect call per ChunkBufferPool page (GL 4.3), so the number of
+// draw calls doesn't grow with view distance. Without GL 4.3 it falls back to one
+// base-vertex draw per chunk. Each chunk's offset reaches the shader as the
+// per-draw attribute aChunkOrigin (location 7).
+class ChunkDrawBatcher {
+public:
+    // Batcher shared by every model
+    static ChunkDrawBatcher& shared();
+    
+    // Queue a mesh drawn at `origin`, relative to the model matrix
+    void add(const ChunkMesh& mesh, const glm::vec3& origin);
+    
+    // Draw and clear the queue. The chunk shader for `layout` must be bound with its
+    // uniforms set; meshes in another layout are skipped. Draws are grouped by pool
+    // page, pages in the order they were first queued, unless keepOrder is set
+    // (blended meshes queued back to front), which costs a call per change of page.
+    // Returns the number of draw calls issued.
+    size_t submit(ChunkMeshLayout layout, bool keepOrder = false);
+    
+    // Multi-draw can be turned off to compare against the fallback loop
+    void setMultiDrawEnabled(bool enabled) { m_multiDrawEnabled = enabled; }
+    bool isMultiDrawEnabled() const { return m_multiDrawEnabled; }
+    
+    // Whether the context has glMultiDrawElementsIndirect
+    static bool isMultiDrawSupported();
+    
+    // Delete the GL objects, must be called while the context is alive
+    void release();
+    
+private:
+    ChunkDrawBatcher();
+    
+    struct QueuedDraw {
+        const ChunkMesh* mesh;
+        glm::vec3 origin;
+    };
+    
+    // VAO reading a whole pool page, with aChunkOrigin from the origin buffer
+    unsigned int getPageVertexArray(int page);
+    
+    // Grow-only upload that orphans the old storage
+    static void uploadStream(unsigned int target, unsigned int buffer, size_t& capacity,
+                             const void* data, size_t bytes);
+    
+    size_t submitMultiDraw(ChunkMeshLayout layout);
+    size_t submitLoop(ChunkMeshLayout layout);
+    
+    std::vector<QueuedDraw> m_draws;
+    std::vector<size_t> m_pageRanks;    // Order of each page's group in the current submit
+    std::vector<glm::vec3> m_origins;
+    std::vector<uint32_t> m_commands;
+    
+    std::vector<unsigned int> m_pageVAOs;
+    unsigned int m_originBuffer;
+    unsigned int m_indirectBuffer;
+    size_t m_originCapacity;
+    size_t m_indirectCapacity;
+    bool m_multiDrawEnabled;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_DRAW_BATCHER_H
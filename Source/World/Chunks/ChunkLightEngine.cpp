@@ -0,0 +1,473 @@
+#include "ChunkLightEngine.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace Zenith {
+
+namespace {
+
+const int kMaxLight = 15;
+
+// Step to the neighbouring cell through each face, in Voxel face order:
+// TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+const int kFaceSteps[6][3] = {
+    { 0,  1,  0},
+    { 0, -1,  0},
+    { 0,  0,  1},
+    { 0,  0, -1},
+    {-1,  0,  0},
+    { 1,  0,  0}
+};
+
+const int kFaceBottom = 1;
+
+int channelLevel(uint8_t light, int channel) {
+    return channel == 0 ? light >> 4 : light & 15;
+}
+
+uint8_t withChannelLevel(uint8_t light, int channel, int level) {
+    return channel == 0 ? static_cast<uint8_t>((light & 0x0F) | (level << 4))
+                        : static_cast<uint8_t>((light & 0xF0) | level);
+}
+
+// Faces of the chunk a cell lies on, one bit per face
+uint8_t borderFaces(int x, int y, int z) {
+    uint8_t faces = 0;
+    if (y == CHUNK_SIZE - 1) faces |= 1 << 0;
+    if (y == 0)              faces |= 1 << 1;
+    if (z == CHUNK_SIZE - 1) faces |= 1 << 2;
+    if (z == 0)              faces |= 1 << 3;
+    if (x == 0)              faces |= 1 << 4;
+    if (x == CHUNK_SIZE - 1) faces |= 1 << 5;
+    return faces;
+}
+
+} // namespace
+
+ChunkLightEngine::ChunkLightEngine(unsigned int threadCount)
+    : m_threadCount(threadCount), m_chunks(nullptr), m_materials(nullptr), m_gridSize(0)
+{
+    if (m_threadCount == 0) {
+        m_threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void ChunkLightEngine::computeAll(std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                                  const std::vector<BlockMaterial>& materials) {
+    auto start = std::chrono::steady_clock::now();
+
+    m_chunks = &chunks;
+    m_materials = &materials;
+    m_gridSize = gridSize;
+    m_work.assign(chunks.size(), ChunkWork());
+    m_queuedChunks.clear();
+    m_blockChanges.clear();
+    m_lastStats = ChunkLightStats();
+
+    // Columns of chunks only write their own chunks, so they seed in parallel.
+    // A chunk is enough work to hand out one at a time.
+    ThreadPool::shared().parallelFor(static_cast<size_t>(gridSize.x) * gridSize.z, [this](size_t column) {
+        seedColumn(static_cast<int>(column % m_gridSize.x), static_cast<int>(column / m_gridSize.x));
+    }, 1, m_threadCount);
+
+    for (size_t index = 0; index < m_work.size(); index++) {
+        if (!m_work[index].additions[SKY].empty() || !m_work[index].additions[BLOCK].empty()) {
+            queueChunk(index);
+        }
+    }
+
+    propagate();
+
+    // Every chunk is remeshed after a full relight, nothing to report
+    for (ChunkWork& work : m_work) {
+        m_lastStats.cellsChanged += work.cellsChanged;
+        work.changed = false;
+        work.changedFaces = 0;
+        work.cellsChanged = 0;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    m_lastStats.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void ChunkLightEngine::queueBlockChange(const glm::ivec3& position) {
+    m_blockChanges.push_back(position);
+}
+
+void ChunkLightEngine::update(std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                              const std::vector<BlockMaterial>& materials, std::vector<size_t>& remeshChunks) {
+    if (m_blockChanges.empty()) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    m_chunks = &chunks;
+    m_materials = &materials;
+    m_gridSize = gridSize;
+    if (m_work.size() != chunks.size()) {
+        m_work.assign(chunks.size(), ChunkWork());
+    }
+    m_lastStats = ChunkLightStats();
+
+    glm::ivec3 cellGrid = gridSize * CHUNK_SIZE;
+
+    for (const glm::ivec3& position : m_blockChanges) {
+        if (glm::any(glm::lessThan(position, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(position, cellGrid))) {
+            continue;
+        }
+
+        glm::ivec3 chunkCoord = position / CHUNK_SIZE;
+        glm::ivec3 local = position % CHUNK_SIZE;
+        size_t index = chunkIndex(chunkCoord.x, chunkCoord.y, chunkCoord.z);
+        Chunk& chunk = *chunks[index];
+        ChunkWork& work = m_work[index];
+        int cell = Chunk::index(local.x, local.y, local.z);
+        bool opaque = isOpaque(chunk.getBlock(cell));
+
+        for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+            // Restart the cell from what it gives off on its own: anything it lit
+            // before is cleared, brighter neighbours fill it back in
+            int previous = channelLevel(chunk.getLight(cell), channel);
+            int source = sourceLevel(chunk, cell, channel);
+            setLevel(index, cell, channel, source);
+
+            if (previous > source) {
+                work.removals[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(previous), 0 });
+            }
+            if (source > 0) {
+                work.additions[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(source), 0 });
+            }
+            if (opaque) {
+                continue;
+            }
+
+            for (const int* step : kFaceSteps) {
+                glm::ivec3 neighbour = position + glm::ivec3(step[0], step[1], step[2]);
+                if (glm::any(glm::lessThan(neighbour, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(neighbour, cellGrid))) {
+                    continue;
+                }
+
+                glm::ivec3 neighbourChunk = neighbour / CHUNK_SIZE;
+                glm::ivec3 neighbourLocal = neighbour % CHUNK_SIZE;
+                size_t neighbourIndex = chunkIndex(neighbourChunk.x, neighbourChunk.y, neighbourChunk.z);
+                int neighbourCell = Chunk::index(neighbourLocal.x, neighbourLocal.y, neighbourLocal.z);
+                int level = channelLevel(chunks[neighbourIndex]->getLight(neighbourCell), channel);
+                if (level > 0) {
+                    m_work[neighbourIndex].additions[channel].push_back(
+                        { static_cast<uint16_t>(neighbourCell), static_cast<uint8_t>(level), 0 });
+                    queueChunk(neighbourIndex);
+                }
+            }
+        }
+
+        queueChunk(index);
+    }
+    m_blockChanges.clear();
+
+    propagate();
+
+    for (size_t index = 0; index < m_work.size(); index++) {
+        ChunkWork& work = m_work[index];
+        if (!work.changed) {
+            continue;
+        }
+
+        // Meshes sample the light in front of each face, so a changed border cell
+        // also affects the neighbour on that side
+        remeshChunks.push_back(index);
+        const glm::ivec3& coord = chunks[index]->getCoord();
+        for (int face = 0; face < 6; face++) {
+            if (!(work.changedFaces & (1 << face))) {
+                continue;
+            }
+            glm::ivec3 neighbour = coord + glm::ivec3(kFaceSteps[face][0], kFaceSteps[face][1], kFaceSteps[face][2]);
+            if (glm::all(glm::greaterThanEqual(neighbour, glm::ivec3(0))) && glm::all(glm::lessThan(neighbour, gridSize))) {
+                remeshChunks.push_back(chunkIndex(neighbour.x, neighbour.y, neighbour.z));
+            }
+        }
+
+        m_lastStats.cellsChanged += work.cellsChanged;
+        work.changed = false;
+        work.changedFaces = 0;
+        work.cellsChanged = 0;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    m_lastStats.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void ChunkLightEngine::seedColumn(int cx, int cz) {
+    const int stride = CHUNK_SIZE + 2;
+    const int gridHeight = m_gridSize.y * CHUNK_SIZE;
+
+    // Lowest y reached by sky light falling straight down, per column of cells
+    // including a one column border. Columns outside the grid never need light.
+    std::vector<int> skyFloor(stride * stride, 0);
+    for (int z = -1; z <= CHUNK_SIZE; z++) {
+        for (int x = -1; x <= CHUNK_SIZE; x++) {
+            int gx = cx * CHUNK_SIZE + x;
+            int gz = cz * CHUNK_SIZE + z;
+            if (gx < 0 || gz < 0 || gx >= m_gridSize.x * CHUNK_SIZE || gz >= m_gridSize.z * CHUNK_SIZE) {
+                continue;
+            }
+
+            int floor = 0;
+            for (int cy = m_gridSize.y - 1; cy >= 0 && floor == 0; cy--) {
+                const Chunk& chunk = *(*m_chunks)[chunkIndex(gx / CHUNK_SIZE, cy, gz / CHUNK_SIZE)];
+                if (chunk.isEmpty()) {
+                    continue;
+                }
+                for (int y = CHUNK_SIZE - 1; y >= 0; y--) {
+                    if (isOpaque(chunk.getBlock(gx % CHUNK_SIZE, y, gz % CHUNK_SIZE))) {
+                        floor = cy * CHUNK_SIZE + y + 1;
+                        break;
+                    }
+                }
+            }
+            skyFloor[(z + 1) * stride + (x + 1)] = floor;
+        }
+    }
+
+    for (int cy = m_gridSize.y - 1; cy >= 0; cy--) {
+        size_t index = chunkIndex(cx, cy, cz);
+        Chunk& chunk = *(*m_chunks)[index];
+        ChunkWork& work = m_work[index];
+        int minY = cy * CHUNK_SIZE;
+
+        bool allOpen = true;
+        for (int z = 0; z < CHUNK_SIZE && allOpen; z++) {
+            for (int x = 0; x < CHUNK_SIZE && allOpen; x++) {
+                allOpen = skyFloor[(z + 1) * stride + (x + 1)] <= minY;
+            }
+        }
+
+        // Chunks entirely in open sky keep no per-cell storage
+        chunk.fillLight(allOpen ? CHUNK_FULL_SKY_LIGHT : 0);
+
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            int gy = minY + y;
+            if (gy >= gridHeight) {
+                break;
+            }
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                for (int x = 0; x < CHUNK_SIZE; x++) {
+                    if (gy < skyFloor[(z + 1) * stride + (x + 1)]) {
+                        continue;
+                    }
+
+                    int cell = Chunk::index(x, y, z);
+                    if (!allOpen) {
+                        chunk.setLight(cell, CHUNK_FULL_SKY_LIGHT);
+                    }
+
+                    // Only cells next to a darker column have anywhere to spread
+                    bool darkerNeighbour = skyFloor[(z + 1) * stride + x] > gy
+                                        || skyFloor[(z + 1) * stride + (x + 2)] > gy
+                                        || skyFloor[z * stride + (x + 1)] > gy
+                                        || skyFloor[(z + 2) * stride + (x + 1)] > gy;
+                    if (darkerNeighbour) {
+                        work.additions[SKY].push_back({ static_cast<uint16_t>(cell), kMaxLight, 0 });
+                    }
+                }
+            }
+        }
+
+        if (chunk.isEmpty()) {
+            continue;
+        }
+        for (int cell = 0; cell < CHUNK_VOLUME; cell++) {
+            int emission = sourceLevel(chunk, cell, BLOCK);
+            if (emission > 0) {
+                chunk.setLight(cell, withChannelLevel(chunk.getLight(cell), BLOCK, emission));
+                work.additions[BLOCK].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(emission), 0 });
+            }
+        }
+    }
+}
+
+void ChunkLightEngine::processChunk(size_t index) {
+    Chunk& chunk = *(*m_chunks)[index];
+    ChunkWork& work = m_work[index];
+    const glm::ivec3& coord = chunk.getCoord();
+
+    // Light leaving the chunk goes to the neighbour's inbox for the next pass
+    auto post = [&](int face, int x, int y, int z, const LightNode& node, int channel, bool removal) {
+        glm::ivec3 neighbour = coord + glm::ivec3(kFaceSteps[face][0], kFaceSteps[face][1], kFaceSteps[face][2]);
+        if (glm::any(glm::lessThan(neighbour, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(neighbour, m_gridSize))) {
+            return;
+        }
+        LightNode wrapped = node;
+        wrapped.cell = static_cast<uint16_t>(Chunk::index((x + CHUNK_SIZE) % CHUNK_SIZE, (y + CHUNK_SIZE) % CHUNK_SIZE,
+                                                          (z + CHUNK_SIZE) % CHUNK_SIZE));
+        work.outbox[face].push_back({ wrapped, static_cast<uint8_t>(channel), removal });
+    };
+
+    // A neighbour of cell lost `removed` light. Cells it fed are cleared back to
+    // their own source level and spread the removal; brighter cells have another
+    // source and light the cleared area again.
+    auto checkRemoval = [&](int cell, int channel, int removed, bool fromAbove) {
+        int current = channelLevel(chunk.getLight(cell), channel);
+        if (current == 0) {
+            return;
+        }
+
+        bool fed = current < removed || (channel == SKY && fromAbove && removed == kMaxLight && current == kMaxLight);
+        if (fed) {
+            int source = sourceLevel(chunk, cell, channel);
+            setLevel(index, cell, channel, source);
+            work.removals[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(current), 0 });
+            if (source > 0) {
+                work.additions[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(source), 0 });
+            }
+        } else {
+            work.additions[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(current), 0 });
+        }
+    };
+
+    auto offer = [&](int cell, int channel, int level) {
+        if (isOpaque(chunk.getBlock(cell)) || channelLevel(chunk.getLight(cell), channel) >= level) {
+            return;
+        }
+        setLevel(index, cell, channel, level);
+        work.additions[channel].push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(level), 0 });
+    };
+
+    // Removals first, so the additions re-light from the sources that are left
+    for (const LightMessage& message : work.inbox) {
+        if (message.removal) {
+            checkRemoval(message.node.cell, message.channel, message.node.level, message.node.fromAbove != 0);
+        }
+    }
+
+    for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+        std::vector<LightNode>& removals = work.removals[channel];
+        for (size_t i = 0; i < removals.size(); i++) {
+            LightNode node = removals[i];
+            int x = node.cell % CHUNK_SIZE;
+            int z = (node.cell / CHUNK_SIZE) % CHUNK_SIZE;
+            int y = node.cell / (CHUNK_SIZE * CHUNK_SIZE);
+
+            for (int face = 0; face < 6; face++) {
+                int nx = x + kFaceSteps[face][0];
+                int ny = y + kFaceSteps[face][1];
+                int nz = z + kFaceSteps[face][2];
+                bool fromAbove = face == kFaceBottom;
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_SIZE || ny >= CHUNK_SIZE || nz >= CHUNK_SIZE) {
+                    post(face, nx, ny, nz, { 0, node.level, static_cast<uint8_t>(fromAbove) }, channel, true);
+                } else {
+                    checkRemoval(Chunk::index(nx, ny, nz), channel, node.level, fromAbove);
+                }
+            }
+        }
+        removals.clear();
+    }
+
+    for (const LightMessage& message : work.inbox) {
+        if (!message.removal) {
+            offer(message.node.cell, message.channel, message.node.level);
+        }
+    }
+    work.inbox.clear();
+
+    for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+        std::vector<LightNode>& additions = work.additions[channel];
+        for (size_t i = 0; i < additions.size(); i++) {
+            int cell = additions[i].cell;
+            int level = channelLevel(chunk.getLight(cell), channel);
+            int x = cell % CHUNK_SIZE;
+            int z = (cell / CHUNK_SIZE) % CHUNK_SIZE;
+            int y = cell / (CHUNK_SIZE * CHUNK_SIZE);
+
+            for (int face = 0; face < 6; face++) {
+                // Full sky light falls straight down without fading
+                int spread = (channel == SKY && face == kFaceBottom && level == kMaxLight) ? kMaxLight : level - 1;
+                if (spread <= 0) {
+                    continue;
+                }
+
+                int nx = x + kFaceSteps[face][0];
+                int ny = y + kFaceSteps[face][1];
+                int nz = z + kFaceSteps[face][2];
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_SIZE || ny >= CHUNK_SIZE || nz >= CHUNK_SIZE) {
+                    post(face, nx, ny, nz, { 0, static_cast<uint8_t>(spread), 0 }, channel, false);
+                } else {
+                    offer(Chunk::index(nx, ny, nz), channel, spread);
+                }
+            }
+        }
+        additions.clear();
+    }
+}
+
+void ChunkLightEngine::propagate() {
+    std::vector<size_t> pass;
+    while (!m_queuedChunks.empty()) {
+        pass.swap(m_queuedChunks);
+        m_queuedChunks.clear();
+        for (size_t index : pass) {
+            m_work[index].queued = false;
+        }
+
+        m_lastStats.passes++;
+        m_lastStats.chunksProcessed += pass.size();
+        ThreadPool::shared().parallelFor(pass.size(), [this, &pass](size_t i) {
+            processChunk(pass[i]);
+        }, 1, m_threadCount);
+
+        // Deliver what crossed chunk borders, single threaded
+        for (size_t index : pass) {
+            const glm::ivec3& coord = (*m_chunks)[index]->getCoord();
+            for (int face = 0; face < 6; face++) {
+                std::vector<LightMessage>& outbox = m_work[index].outbox[face];
+                if (outbox.empty()) {
+                    continue;
+                }
+                size_t neighbour = chunkIndex(coord.x + kFaceSteps[face][0], coord.y + kFaceSteps[face][1],
+                                              coord.z + kFaceSteps[face][2]);
+                std::vector<LightMessage>& inbox = m_work[neighbour].inbox;
+                inbox.insert(inbox.end(), outbox.begin(), outbox.end());
+                outbox.clear();
+                queueChunk(neighbour);
+            }
+        }
+    }
+}
+
+void ChunkLightEngine::queueChunk(size_t index) {
+    ChunkWork& work = m_work[index];
+    if (!work.queued) {
+        work.queued = true;
+        m_queuedChunks.push_back(index);
+    }
+}
+
+void ChunkLightEngine::setLevel(size_t index, int cell, int channel, int level) {
+    Chunk& chunk = *(*m_chunks)[index];
+    uint8_t light = chunk.getLight(cell);
+    uint8_t updated = withChannelLevel(light, channel, level);
+    if (updated == light) {
+        return;
+    }
+
+    chunk.setLight(cell, updated);
+    ChunkWork& work = m_work[index];
+    work.changed = true;
+    work.cellsChanged++;
+    work.changedFaces |= borderFaces(cell % CHUNK_SIZE, cell / (CHUNK_SIZE * CHUNK_SIZE), (cell / CHUNK_SIZE) % CHUNK_SIZE);
+}
+
+uint8_t ChunkLightEngine::sourceLevel(const Chunk& chunk, int cell, int channel) const {
+    uint16_t blockId = chunk.getBlock(cell);
+    if (channel == BLOCK) {
+        return blockId < m_materials->size() ? (*m_materials)[blockId].lightEmission : 0;
+    }
+
+    // The top layer of the grid is lit by the open sky above it
+    bool topLayer = chunk.getCoord().y == m_gridSize.y - 1 && cell / (CHUNK_SIZE * CHUNK_SIZE) == CHUNK_SIZE - 1;
+    return (topLayer && !isOpaque(blockId)) ? kMaxLight : 0;
+}
+
+} // namespace Zenith
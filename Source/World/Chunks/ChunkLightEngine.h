@@ -0,0 +1,132 @@
+#ifndef CHUNK_LIGHT_ENGINE_H
+#define CHUNK_LIGHT_ENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Blocks/BlockMaterial.h"
+#include "Chunk.h"
+
+namespace Zenith {
+
+// Counters of the last computeAll() or update()
+struct ChunkLightStats {
+    size_t passes = 0;          // Rounds of chunk-parallel propagation
+    size_t chunksProcessed = 0; // Chunk visits summed over the passes
+    size_t cellsChanged = 0;
+    double milliseconds = 0.0;
+};
+
+// Flood-fill lighting over a model's chunk grid, two 4-bit channels per cell
+// stored in the chunks (see Chunk::getLight()):
+//
+//   sky light    15 in every non-opaque cell open to the top of the grid, falling
+//                straight down without loss and spreading sideways one level per cell
+//   block light  emitted by blocks with a lightEmission, one level lost per cell
+//
+// Light spreads with breadth-first add queues; a removed block or source runs a
+// removal queue that clears what it lit and re-queues the brighter cells at the
+// edge of the cleared area. Each chunk keeps its own queues and is processed by
+// one worker at a time. Light crossing into a neighbour is posted to it and picked
+// up on the next pass, so chunks never write each other's cells.
+class ChunkLightEngine {
+public:
+    // threadCount 0 uses std::thread::hardware_concurrency()
+    explicit ChunkLightEngine(unsigned int threadCount = 0);
+
+    // Light every chunk from scratch. chunks is a model's chunk list (x fastest,
+    // then z, then y) of gridSize chunks; materials is indexed by palette index.
+    void computeAll(std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                    const std::vector<BlockMaterial>& materials);
+
+    // Remember a block change (model coordinates) for the next update()
+    void queueBlockChange(const glm::ivec3& position);
+    bool hasQueuedChanges() const { return !m_blockChanges.empty(); }
+
+    // Relight around the queued changes. Appends every chunk whose mesh sees a
+    // changed cell to remeshChunks: the chunk itself and the neighbours of
+    // changed border cells.
+    void update(std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                const std::vector<BlockMaterial>& materials, std::vector<size_t>& remeshChunks);
+
+    const ChunkLightStats& getLastStats() const { return m_lastStats; }
+
+private:
+    enum Channel { SKY = 0, BLOCK = 1, CHANNEL_COUNT = 2 };
+
+    struct LightNode {
+        uint16_t cell;      // Linear index in the chunk
+        uint8_t level;
+        uint8_t fromAbove;  // Removals only: the neighbour that lost light is above the cell
+    };
+
+    // Light posted to a neighbouring chunk
+    struct LightMessage {
+        LightNode node;
+        uint8_t channel;
+        bool removal;
+    };
+
+    struct ChunkWork {
+        // Cleared cells with the level they had, and lit cells to spread from
+        std::array<std::vector<LightNode>, CHANNEL_COUNT> removals;
+        std::array<std::vector<LightNode>, CHANNEL_COUNT> additions;
+
+        // Posted by neighbours since the last pass
+        std::vector<LightMessage> inbox;
+
+        // Posted to each neighbour this pass, in Voxel face order
+        std::array<std::vector<LightMessage>, 6> outbox;
+
+        bool queued = false;
+        bool changed = false;
+        uint8_t changedFaces = 0;   // Faces with a changed border cell
+        size_t cellsChanged = 0;
+    };
+
+    // Set the sky columns and emitters of one column of chunks
+    void seedColumn(int cx, int cz);
+
+    // Drain a chunk's queues and inbox, posting light that leaves the chunk
+    void processChunk(size_t index);
+
+    // Run passes until no chunk has queued work
+    void propagate();
+
+    // Queue a chunk for the next pass (not thread safe)
+    void queueChunk(size_t index);
+
+    // Set one channel of a cell, recording the change for remeshing
+    void setLevel(size_t index, int cell, int channel, int level);
+
+    // Level a cell holds with no neighbours: its emission, or full sky at the top of the grid
+    uint8_t sourceLevel(const Chunk& chunk, int cell, int channel) const;
+
+    bool isOpaque(uint16_t blockId) const {
+        return blockId < m_materials->size() && (*m_materials)[blockId].opaque;
+    }
+
+    size_t chunkIndex(int cx, int cy, int cz) const {
+        return (static_cast<size_t>(cy) * m_gridSize.z + cz) * m_gridSize.x + cx;
+    }
+
+    // Most threads of the shared pool a pass uses
+    unsigned int m_threadCount;
+
+    // Bound by computeAll() and update() for the duration of the call
+    std::vector<std::unique_ptr<Chunk>>* m_chunks;
+    const std::vector<BlockMaterial>* m_materials;
+    glm::ivec3 m_gridSize;
+
+    std::vector<ChunkWork> m_work;
+    std::vector<size_t> m_queuedChunks;
+    std::vector<glm::ivec3> m_blockChanges;
+
+    ChunkLightStats m_lastStats;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_LIGHT_ENGINE_H
@@ -0,0 +1,236 @@
+#include "ChunkMesh.h"
+#include "Chunk.h"
+#include "ChunkBufferPool.h"
+#include "Utils/ShaderCache.h"
+#include "Utils/ShaderUtils.h"
+#include <glad/glad.h>
+
+namespace Zenith {
+
+namespace {
+
+// A chunk can't have more faces than 6 per block
+const size_t kMaxQuadsPerChunk = static_cast<size_t>(CHUNK_VOLUME) * 6;
+
+} // namespace
+
+ChunkMesh::ChunkMesh()
+    : m_VAO(0), m_vaoPage(-1), m_vaoOffset(0), m_instanceBuffer(0), m_layout(ChunkMeshLayout::QUAD_VERTICES),
+      m_alphaTested(false), m_vertexCount(0), m_indexCount(0), m_faceCount(0)
+{
+}
+
+ChunkMesh::~ChunkMesh() {
+    // Like Voxel, no GL calls here: models usually outlive the context at shutdown.
+    // Returning the range to the pool is bookkeeping only; use release() to also
+    // free the VAO.
+    ChunkBufferPool::shared().free(m_allocation);
+}
+
+void ChunkMesh::setupBuffers() {
+    // Created before the VAO is bound so it doesn't end up in another VAO
+    unsigned int quadIndices = getQuadIndexBuffer();
+    
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices);
+    glBindVertexArray(0);
+}
+
+void ChunkMesh::upload(const ChunkMeshData& data) {
+    m_layout = data.faces.empty() ? ChunkMeshLayout::QUAD_VERTICES : ChunkMeshLayout::FACE_RECORDS;
+    m_alphaTested = data.alphaTested;
+    m_vertexCount = data.vertices.size();
+    m_indexCount = (data.vertices.size() / 4) * 6;
+    m_faceCount = data.faces.size();
+    
+    ChunkBufferPool& pool = ChunkBufferPool::shared();
+    size_t bytes = data.getByteCount();
+    
+    // Keep the range when the new mesh fits without wasting most of it
+    if (m_allocation.isValid() && (bytes > m_allocation.size || bytes < m_allocation.size / 2)) {
+        pool.free(m_allocation);
+    }
+    
+    if (isEmpty()) {
+        pool.free(m_allocation);
+        return;
+    }
+    
+    if (!m_allocation.isValid() && !pool.allocate(m_allocation, bytes)) {
+        m_vertexCount = m_indexCount = m_faceCount = 0;
+        return;
+    }
+    
+    if (m_layout == ChunkMeshLayout::FACE_RECORDS) {
+        pool.upload(m_allocation, data.faces.data(), bytes);
+        return;
+    }
+    pool.upload(m_allocation, data.vertices.data(), bytes);
+    
+    if (m_VAO == 0) {
+        setupBuffers();
+    }
+    syncVertexArray();
+}
+
+void ChunkMesh::syncVertexArray() const {
+    // Point the vertex attribute at the mesh's range whenever it moved (a new
+    // range, or the pool compacting its page)
+    if (m_VAO == 0 || !m_allocation.isValid() ||
+        (m_vaoPage == m_allocation.page && m_vaoOffset == m_allocation.offset)) {
+        return;
+    }
+    
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, ChunkBufferPool::shared().getBuffer(m_allocation.page));
+    
+    // Both packed words as one integer attribute
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex), (void*)m_allocation.offset);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    
+    m_vaoPage = m_allocation.page;
+    m_vaoOffset = m_allocation.offset;
+}
+
+void ChunkMesh::draw() const {
+    if (isEmpty()) {
+        return;
+    }
+    
+    if (m_layout == ChunkMeshLayout::FACE_RECORDS) {
+        // Six vertices per face, chunk_face_vertex.glsl fetches its face from gl_VertexID,
+        // which starts at `first`, so the whole page can stay bound
+        glBindVertexArray(getEmptyVertexArray());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ChunkBufferPool::shared().getBuffer(m_allocation.page));
+        glDrawArrays(GL_TRIANGLES, static_cast<GLint>(getBaseElement() * 6), static_cast<GLsizei>(m_faceCount * 6));
+    } else {
+        syncVertexArray();
+        glBindVertexArray(m_VAO);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), GL_UNSIGNED_INT, (void*)0);
+    }
+    glBindVertexArray(0);
+}
+
+void ChunkMesh::bindInstanceBuffer(unsigned int buffer) {
+    if (m_VAO == 0 || m_instanceBuffer == buffer) {
+        return;
+    }
+    
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    
+    // A mat4 attribute takes four consecutive vec4 locations
+    for (int column = 0; column < 4; column++) {
+        GLuint location = 3 + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float),
+                              (void*)(column * 4 * sizeof(float)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    
+    glBindVertexArray(0);
+    m_instanceBuffer = buffer;
+}
+
+void ChunkMesh::drawInstanced(size_t instanceCount) const {
+    if (m_indexCount == 0 || instanceCount == 0 || m_instanceBuffer == 0) {
+        // Also skips FACE_RECORDS meshes, which have no indexed vertices
+        return;
+    }
+    
+    syncVertexArray();
+    glBindVertexArray(m_VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), GL_UNSIGNED_INT, (void*)0,
+                            static_cast<GLsizei>(instanceCount));
+    glBindVertexArray(0);
+}
+
+void ChunkMesh::release() {
+    if (m_VAO != 0) {
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    ChunkBufferPool::shared().free(m_allocation);
+    
+    m_VAO = 0;
+    m_vaoPage = -1;
+    m_vaoOffset = 0;
+    m_instanceBuffer = 0;
+    m_vertexCount = 0;
+    m_indexCount = 0;
+    m_faceCount = 0;
+}
+
+unsigned int ChunkMesh::getShaderProgram(ChunkMeshLayout layout, unsigned int features) {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + (layout == ChunkMeshLayout::FACE_RECORDS ? "/chunk_face_vertex.glsl" : "/chunk_vertex.glsl"),
+        std::string(SHADER_DIR) + "/chunk_fragment.glsl",
+        features
+    );
+}
+
+unsigned int ChunkMesh::getDepthShaderProgram(ChunkMeshLayout layout, bool alphaTest) {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + (layout == ChunkMeshLayout::FACE_RECORDS ? "/chunk_face_vertex.glsl" : "/chunk_vertex.glsl"),
+        std::string(SHADER_DIR) + "/shadow_depth_fragment.glsl",
+        alphaTest ? ShaderUtils::ALPHA_TEST : 0u
+    );
+}
+
+unsigned int ChunkMesh::getDebugShaderProgram(ChunkMeshLayout layout, ChunkDebugView view, bool alphaTest) {
+    if (view == ChunkDebugView::NONE) {
+        return 0;
+    }
+    
+    std::vector<std::string> defines;
+    if (view == ChunkDebugView::OVERDRAW) {
+        defines.push_back("DEBUG_OVERDRAW");
+    } else if (view == ChunkDebugView::TRIANGLE_DENSITY) {
+        defines.push_back("DEBUG_TRIANGLE_DENSITY");
+    } else if (view == ChunkDebugView::CHUNK_BOUNDS) {
+        defines.push_back("DEBUG_CHUNK_BOUNDS");
+    }
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + (layout == ChunkMeshLayout::FACE_RECORDS ? "/chunk_face_vertex.glsl" : "/chunk_vertex.glsl"),
+        std::string(SHADER_DIR) + "/chunk_debug_fragment.glsl",
+        alphaTest ? ShaderUtils::ALPHA_TEST : 0u,
+        defines
+    );
+}
+
+bool ChunkMesh::isFacePullingSupported() {
+    return GLAD_GL_VERSION_4_3 && getShaderProgram(ChunkMeshLayout::FACE_RECORDS) != 0;
+}
+
+unsigned int ChunkMesh::getEmptyVertexArray() {
+    static unsigned int vao = 0;
+    
+    if (vao == 0) {
+        glGenVertexArrays(1, &vao);
+    }
+    
+    return vao;
+}
+
+unsigned int ChunkMesh::getQuadIndexBuffer() {
+    static unsigned int buffer = 0;
+    
+    if (buffer == 0) {
+        std::vector<unsigned int> indices;
+        indices.reserve(kMaxQuadsPerChunk * 6);
+        for (size_t quad = 0; quad < kMaxQuadsPerChunk; quad++) {
+            unsigned int v = static_cast<unsigned int>(quad * 4);
+            indices.insert(indices.end(), { v, v + 1, v + 2, v + 2, v + 3, v });
+        }
+        
+        glBindVertexArray(0);
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    }
+    
+    return buffer;
+}
+
+} // namespace Zenith
@@ -0,0 +1,144 @@
+#ifndef CHUNK_MESH_H
+#define CHUNK_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ChunkBufferPool.h"
+#include "ChunkVertex.h"
+
+namespace Zenith {
+
+// How chunk faces reach the GPU
+enum class ChunkMeshLayout {
+    QUAD_VERTICES,  // Four ChunkVertex per face in a VBO, drawn with the shared quad index buffer
+    FACE_RECORDS    // One ChunkFace per face in a shader storage buffer, expanded by the vertex shader (GL 4.3)
+};
+
+// Debug colourings replacing the shading of the chunk passes (see BaseModel::setDebugView)
+enum class ChunkDebugView {
+    NONE,
+    OVERDRAW,           // Additive count of the fragments written to each pixel
+    TRIANGLE_DENSITY,   // Triangles per pixel, blue for large faces to red for one or more per pixel
+    CHUNK_BOUNDS,       // Chunk borders over a colour per chunk
+    LOD_LEVELS,         // Colour per detail level
+    VERTEX_COUNT        // Vertices in the chunk's meshes, blue for few to red for many
+};
+
+constexpr int CHUNK_DEBUG_VIEW_COUNT = 6;
+
+// CPU side mesh of a chunk, ready to be uploaded. Only the array matching the
+// mesher's layout is filled: quads of four consecutive vertices, or face records.
+struct ChunkMeshData {
+    std::vector<ChunkVertex> vertices;
+    std::vector<ChunkFace> faces;
+    
+    // Whether any face has see-through texels and needs the alpha tested program
+    bool alphaTested = false;
+    
+    void clear() {
+        vertices.clear();
+        faces.clear();
+        alphaTested = false;
+    }
+    
+    size_t getQuadCount() const { return vertices.size() / 4 + faces.size(); }
+    size_t getByteCount() const { return vertices.size() * sizeof(ChunkVertex) + faces.size() * sizeof(ChunkFace); }
+};
+
+// GPU side of one chunk: a range in the shared ChunkBufferPool plus a VAO for
+// drawing it on its own. Remeshing reuses the range when the new mesh fits, so it
+// never creates GL objects; ChunkDrawBatcher draws many meshes per call. The pool
+// tracks the range by address, so meshes can't be copied or moved.
+class ChunkMesh {
+public:
+    ChunkMesh();
+    ~ChunkMesh();
+    
+    ChunkMesh(const ChunkMesh&) = delete;
+    ChunkMesh& operator=(const ChunkMesh&) = delete;
+    
+    // Replace the mesh contents with new data, in whichever layout it was built
+    void upload(const ChunkMeshData& data);
+    
+    // Draw the chunk on its own. The caller is expected to have the chunk shader for
+    // the mesh's layout bound with its uniforms set, the chunk offset in the current
+    // value of attribute 7 (glVertexAttrib3f) and the block texture array bound to
+    // unit 0. Models batch their chunks with ChunkDrawBatcher instead.
+    void draw() const;
+    
+    // Attach a buffer of per-instance mat4s to attribute locations 3-6, for drawInstanced()
+    void bindInstanceBuffer(unsigned int buffer);
+    
+    // Draw the mesh `instanceCount` times with the instance buffer bound above.
+    // Only meshes in the QUAD_VERTICES layout can be instanced.
+    void drawInstanced(size_t instanceCount) const;
+    
+    // Delete the GL objects, must be called while the context is still alive
+    void release();
+    
+    bool isEmpty() const { return m_indexCount == 0 && m_faceCount == 0; }
+    bool isAlphaTested() const { return m_alphaTested; }
+    ChunkMeshLayout getLayout() const { return m_layout; }
+    size_t getVertexCount() const { return m_vertexCount; }
+    size_t getIndexCount() const { return m_indexCount; }
+    size_t getFaceCount() const { return m_faceCount; }
+    size_t getTriangleCount() const { return m_indexCount / 3 + m_faceCount * 2; }
+    
+    // Where the mesh lives in the buffer pool, and its first vertex (or face) there
+    const ChunkBufferAllocation& getAllocation() const { return m_allocation; }
+    size_t getBaseElement() const { return m_allocation.offset / ChunkBufferPool::ALIGNMENT; }
+    
+    // Bytes of mesh data on the GPU (the shared index buffer is not counted)
+    size_t getMemoryBytes() const { return m_vertexCount * sizeof(ChunkVertex) + m_faceCount * sizeof(ChunkFace); }
+    
+    // Shader program shared by all chunk meshes of a layout, with a mask of
+    // ShaderUtils::Feature compiled in. Without SHADOWS there is no shadow map
+    // code at all; only the ALPHA_TEST permutation discards see-through texels,
+    // without a discard the opaque pass keeps early depth testing.
+    static unsigned int getShaderProgram(ChunkMeshLayout layout = ChunkMeshLayout::QUAD_VERTICES,
+                                         unsigned int features = 0);
+    
+    // Depth-only program of a layout: the layout's vertex shader with the light's
+    // matrix as projection for the shadow pass, or the camera's for the depth
+    // pre-pass. The ALPHA_TEST variant discards transparent texels.
+    static unsigned int getDepthShaderProgram(ChunkMeshLayout layout = ChunkMeshLayout::QUAD_VERTICES,
+                                              bool alphaTest = true);
+    
+    // Program drawing a layout's meshes in a debug view (not NONE), built the first
+    // time the view is asked for. The ALPHA_TEST variant cuts out the leaves' holes.
+    static unsigned int getDebugShaderProgram(ChunkMeshLayout layout, ChunkDebugView view, bool alphaTest);
+    
+    // Whether the context can draw FACE_RECORDS meshes (shader storage buffers need GL 4.3)
+    static bool isFacePullingSupported();
+    
+    // Index buffer with the two triangles of every possible quad of a chunk
+    static unsigned int getQuadIndexBuffer();
+    
+private:
+    // Create the VAO on first upload
+    void setupBuffers();
+    
+    // Re-point the VAO if the pool moved the mesh's range
+    void syncVertexArray() const;
+    
+    // Attribute-less VAO for FACE_RECORDS draws, core profiles need one bound
+    static unsigned int getEmptyVertexArray();
+    
+    ChunkBufferAllocation m_allocation;
+    
+    // The VAO's vertex attribute points at this page and offset
+    unsigned int m_VAO;
+    mutable int m_vaoPage;
+    mutable size_t m_vaoOffset;
+    unsigned int m_instanceBuffer;
+    ChunkMeshLayout m_layout;
+    bool m_alphaTested;
+    size_t m_vertexCount;
+    size_t m_indexCount;
+    size_t m_faceCount;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_MESH_H
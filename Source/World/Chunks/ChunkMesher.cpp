@@ -0,0 +1,227 @@
+#include "ChunkMesher.h"
+#include <algorithm>
+
+namespace Zenith {
+
+namespace {
+
+// Neighbour offset for each face, in Voxel face order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+const int kFaceNormals[6][3] = {
+    { 0,  1,  0},
+    { 0, -1,  0},
+    { 0,  0,  1},
+    { 0,  0, -1},
+    {-1,  0,  0},
+    { 1,  0,  0}
+};
+
+// Corners of each face as offsets from the block's minimum corner, in the same
+// winding as the cube in Voxel::initialize
+const int kFaceCorners[6][4][3] = {
+    // Top face (y+)
+    {{0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1}},
+    // Bottom face (y-)
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}},
+    // Front face (z+)
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}},
+    // Back face (z-)
+    {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}},
+    // Left face (x-)
+    {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}},
+    // Right face (x+)
+    {{1, 0, 0}, {1, 0, 1}, {1, 1, 1}, {1, 1, 0}}
+};
+
+// The two axes spanning each face, the third is the face normal
+const int kFaceTangents[6][2] = {
+    {0, 2}, {0, 2}, {0, 1}, {0, 1}, {1, 2}, {1, 2}
+};
+
+bool isOccluder(uint16_t blockId, const std::vector<BlockMaterial>& materials) {
+    return blockId != 0 && blockId < materials.size() && materials[blockId].opaque;
+}
+
+// Ambient occlusion of one face corner from the three cells touching it in the
+// layer in front of the face: two sides and the diagonal. Two sides hide the
+// diagonal completely, 0 is darkest and CHUNK_VERTEX_MAX_AO unoccluded.
+int cornerOcclusion(const uint16_t* paddedBlocks, int size, const int cell[3], int face, const int corner[3],
+                    const std::vector<BlockMaterial>& materials) {
+    int side1[3] = { cell[0] + kFaceNormals[face][0], cell[1] + kFaceNormals[face][1], cell[2] + kFaceNormals[face][2] };
+    int side2[3] = { side1[0], side1[1], side1[2] };
+    int diagonal[3] = { side1[0], side1[1], side1[2] };
+    
+    int axis1 = kFaceTangents[face][0];
+    int axis2 = kFaceTangents[face][1];
+    int step1 = corner[axis1] ? 1 : -1;
+    int step2 = corner[axis2] ? 1 : -1;
+    side1[axis1] += step1;
+    side2[axis2] += step2;
+    diagonal[axis1] += step1;
+    diagonal[axis2] += step2;
+    
+    bool occluded1 = isOccluder(paddedBlocks[ChunkMesher::paddedIndex(side1[0], side1[1], side1[2], size)], materials);
+    bool occluded2 = isOccluder(paddedBlocks[ChunkMesher::paddedIndex(side2[0], side2[1], side2[2], size)], materials);
+    if (occluded1 && occluded2) {
+        return 0;
+    }
+    bool occludedDiagonal = isOccluder(paddedBlocks[ChunkMesher::paddedIndex(diagonal[0], diagonal[1], diagonal[2], size)],
+                                       materials);
+    return CHUNK_VERTEX_MAX_AO - (occluded1 ? 1 : 0) - (occluded2 ? 1 : 0) - (occludedDiagonal ? 1 : 0);
+}
+
+// Centre of a quad of four ChunkVertex, from the corners packed in data0
+glm::vec3 quadCenter(const ChunkVertex* quad) {
+    glm::vec3 sum(0.0f);
+    for (int corner = 0; corner < 4; corner++) {
+        uint32_t data = quad[corner].data0;
+        sum += glm::vec3(static_cast<float>(data & 31), static_cast<float>((data >> 5) & 31),
+                         static_cast<float>((data >> 10) & 31));
+    }
+    return sum * 0.25f;
+}
+
+// Centre of a face record: the middle of its cell, pushed out to the face
+glm::vec3 faceCenter(const ChunkFace& record) {
+    uint32_t data = record.data0;
+    glm::vec3 cell(static_cast<float>(data & 31), static_cast<float>((data >> 5) & 31),
+                   static_cast<float>((data >> 10) & 31));
+    int face = (data >> 15) & 7;
+    float half = static_cast<float>(1 << ((data >> 18) & 3)) * 0.5f;
+    glm::vec3 normal(kFaceNormals[face][0], kFaceNormals[face][1], kFaceNormals[face][2]);
+    return cell + glm::vec3(half) + normal * half;
+}
+
+} // namespace
+
+void ChunkMesher::build(const uint16_t* paddedBlocks, const uint8_t* paddedLight,
+                        const std::vector<BlockMaterial>& materials, ChunkMeshData& out,
+                        ChunkMeshData* translucentOut, ChunkMeshData* cutoutOut) {
+    build(paddedBlocks, paddedLight, CHUNK_SIZE, 1, materials, out, translucentOut, cutoutOut);
+}
+
+void ChunkMesher::build(const uint16_t* paddedBlocks, const uint8_t* paddedLight, int size, int scale,
+                        const std::vector<BlockMaterial>& materials, ChunkMeshData& out,
+                        ChunkMeshData* translucentOut, ChunkMeshData* cutoutOut) {
+    out.clear();
+    if (translucentOut) {
+        translucentOut->clear();
+    }
+    if (cutoutOut) {
+        cutoutOut->clear();
+    }
+    
+    // Face records store the cell size as a power of two
+    int sizeLog2 = 0;
+    while ((1 << sizeLog2) < scale) {
+        sizeLog2++;
+    }
+    
+    for (int y = 0; y < size; y++) {
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                uint16_t blockId = paddedBlocks[paddedIndex(x, y, z, size)];
+                if (blockId == 0 || blockId >= materials.size() || !materials[blockId].visible) {
+                    continue;
+                }
+                
+                const BlockMaterial& material = materials[blockId];
+                ChunkMeshData* target = &out;
+                if (translucentOut && material.translucent) {
+                    target = translucentOut;
+                } else if (cutoutOut && material.cutout) {
+                    target = cutoutOut;
+                }
+                if (!material.opaque && !material.solid) {
+                    target->alphaTested = true;
+                }
+                
+                for (int face = 0; face < 6; face++) {
+                    // Skip faces hidden behind an opaque or solid neighbour, and faces
+                    // between two cells of the same translucent block (inside a glass
+                    // wall or a body of water), which would otherwise blend twice
+                    int neighbour = paddedIndex(x + kFaceNormals[face][0], y + kFaceNormals[face][1],
+                                                z + kFaceNormals[face][2], size);
+                    uint16_t neighbourId = paddedBlocks[neighbour];
+                    if (neighbourId != 0 && neighbourId < materials.size() &&
+                        (materials[neighbourId].opaque || materials[neighbourId].solid)) {
+                        continue;
+                    }
+                    if (neighbourId == blockId && material.translucent) {
+                        continue;
+                    }
+                    
+                    // The face is lit by the cell it looks into
+                    uint8_t light = paddedLight ? paddedLight[neighbour] : CHUNK_FULL_SKY_LIGHT;
+                    int skyLight = light >> 4;
+                    int blockLight = light & 15;
+                    
+                    // Baked at mesh time, the shader only interpolates it
+                    int cell[3] = { x, y, z };
+                    int ao[4];
+                    for (int corner = 0; corner < 4; corner++) {
+                        ao[corner] = cornerOcclusion(paddedBlocks, size, cell, face, kFaceCorners[face][corner], materials);
+                    }
+                    
+                    // Quads are split along the 0-2 diagonal. When the other diagonal is
+                    // brighter, split along it instead so the gradient stays symmetric.
+                    bool flip = ao[0] + ao[2] < ao[1] + ao[3];
+                    
+                    if (m_layout == ChunkMeshLayout::FACE_RECORDS) {
+                        int cornerAo = ao[0] | (ao[1] << 2) | (ao[2] << 4) | (ao[3] << 6);
+                        target->faces.push_back(packChunkFace(x * scale, y * scale, z * scale,
+                                                          face, sizeLog2, material.faceLayers[face], cornerAo, flip,
+                                                          skyLight, blockLight));
+                        continue;
+                    }
+                    
+                    // A coarse cell spans `scale` blocks, corners stay in block units. Starting
+                    // at corner 1 moves the shared index buffer's diagonal to 1-3.
+                    for (int i = 0; i < 4; i++) {
+                        int corner = (i + (flip ? 1 : 0)) & 3;
+                        const int* c = kFaceCorners[face][corner];
+                        target->vertices.push_back(packChunkVertex((x + c[0]) * scale,
+                                                               (y + c[1]) * scale,
+                                                               (z + c[2]) * scale,
+                                                               face, ao[corner], material.faceLayers[face],
+                                                               skyLight, blockLight));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::sortBackToFront(ChunkMeshData& data, const glm::vec3& eye) {
+    bool faces = !data.faces.empty();
+    size_t quadCount = data.getQuadCount();
+    
+    m_sortKeys.clear();
+    for (size_t quad = 0; quad < quadCount; quad++) {
+        glm::vec3 offset = (faces ? faceCenter(data.faces[quad]) : quadCenter(&data.vertices[quad * 4])) - eye;
+        m_sortKeys.emplace_back(glm::dot(offset, offset), static_cast<uint32_t>(quad));
+    }
+    
+    // Ties keep their mesh order, so the same eye always gives the same result
+    std::sort(m_sortKeys.begin(), m_sortKeys.end(),
+              [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+                  return a.first > b.first || (a.first == b.first && a.second < b.second);
+              });
+    
+    if (faces) {
+        m_sortedFaces.clear();
+        for (const auto& key : m_sortKeys) {
+            m_sortedFaces.push_back(data.faces[key.second]);
+        }
+        data.faces.swap(m_sortedFaces);
+        return;
+    }
+    
+    m_sortedVertices.clear();
+    for (const auto& key : m_sortKeys) {
+        const ChunkVertex* quad = &data.vertices[static_cast<size_t>(key.second) * 4];
+        m_sortedVertices.insert(m_sortedVertices.end(), quad, quad + 4);
+    }
+    data.vertices.swap(m_sortedVertices);
+}
+
+} // namespace Zenith
@@ -0,0 +1,70 @@
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Blocks/BlockMaterial.h"
+#include "Chunk.h"
+#include "ChunkMesh.h"
+
+namespace Zenith {
+
+// The mesher reads a chunk plus a one block border from its neighbours, so faces
+// on the chunk edge can be culled against the adjacent chunk
+constexpr int PADDED_CHUNK_SIZE = CHUNK_SIZE + 2;
+constexpr int PADDED_CHUNK_VOLUME = PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE;
+
+class ChunkMesher {
+public:
+    ChunkMesher() : m_layout(ChunkMeshLayout::QUAD_VERTICES) {}
+    
+    // Whether build() emits quad vertices or face records
+    void setLayout(ChunkMeshLayout layout) { m_layout = layout; }
+    ChunkMeshLayout getLayout() const { return m_layout; }
+    
+    // Index into a padded block array, x/y/z range from -1 to CHUNK_SIZE inclusive
+    static int paddedIndex(int x, int y, int z) {
+        return ((y + 1) * PADDED_CHUNK_SIZE + (z + 1)) * PADDED_CHUNK_SIZE + (x + 1);
+    }
+    
+    // Index into a padded grid of `size` cells per axis plus the border
+    static int paddedIndex(int x, int y, int z, int size) {
+        return ((y + 1) * (size + 2) + (z + 1)) * (size + 2) + (x + 1);
+    }
+    
+    // Build the visible faces of a chunk. paddedBlocks holds PADDED_CHUNK_VOLUME palette
+    // indices and materials is indexed by palette index. paddedLight holds the packed
+    // light of the same cells (see Chunk::getLight()), each face takes the light of
+    // the cell in front of it; nullptr lights everything with full sky light.
+    // Faces of translucent and cutout blocks go to translucentOut and cutoutOut
+    // when given, else to out.
+    void build(const uint16_t* paddedBlocks, const uint8_t* paddedLight,
+               const std::vector<BlockMaterial>& materials, ChunkMeshData& out,
+               ChunkMeshData* translucentOut = nullptr, ChunkMeshData* cutoutOut = nullptr);
+    
+    // Same for a downsampled chunk: a padded grid of `size` cells per axis, each cell
+    // covering `scale` blocks. Vertices stay in block units so the result replaces
+    // the full resolution mesh as is.
+    void build(const uint16_t* paddedBlocks, const uint8_t* paddedLight, int size, int scale,
+               const std::vector<BlockMaterial>& materials, ChunkMeshData& out,
+               ChunkMeshData* translucentOut = nullptr, ChunkMeshData* cutoutOut = nullptr);
+    
+    // Reorder the faces of a mesh farthest first from `eye`, in the chunk's block
+    // units (0..CHUNK_SIZE), so blending them in order composites correctly
+    void sortBackToFront(ChunkMeshData& data, const glm::vec3& eye);
+    
+private:
+    ChunkMeshLayout m_layout;
+    
+    // Scratch reused by every sort: squared distance and face index, and the
+    // reordered faces
+    std::vector<std::pair<float, uint32_t>> m_sortKeys;
+    std::vector<ChunkVertex> m_sortedVertices;
+    std::vector<ChunkFace> m_sortedFaces;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_MESHER_H
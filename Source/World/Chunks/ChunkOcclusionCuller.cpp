@@ -0,0 +1,155 @@
+#include "ChunkOcclusionCuller.h"
+#include "Utils/ShaderCache.h"
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <string>
+
+namespace Zenith {
+
+namespace {
+
+// Boxes are grown a little so a chunk's own surface, which lies on its box,
+// doesn't hide the box
+const float kBoxMargin = 0.05f;
+
+} // namespace
+
+ChunkOcclusionCuller::ChunkOcclusionCuller() = default;
+
+void ChunkOcclusionCuller::resize(size_t chunkCount) {
+    if (m_states.size() < chunkCount) {
+        m_states.resize(chunkCount);
+    }
+}
+
+bool ChunkOcclusionCuller::isOccluded(size_t chunkIndex, const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                      const glm::vec3& viewPos) {
+    ChunkState& state = m_states[chunkIndex];
+    
+    if (state.pending) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(state.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint samplesPassed = 0;
+            glGetQueryObjectuiv(state.query, GL_QUERY_RESULT, &samplesPassed);
+            state.occluded = samplesPassed == 0;
+            state.pending = false;
+        }
+    }
+    
+    // From inside, the box's faces are behind the near plane or facing away
+    glm::vec3 margin(kBoxMargin + 0.5f);
+    bool inside = glm::all(glm::greaterThanEqual(viewPos, boxMin - margin)) &&
+                  glm::all(glm::lessThanEqual(viewPos, boxMax + margin));
+    if (inside) {
+        state.occluded = false;
+    }
+    
+    return state.occluded;
+}
+
+void ChunkOcclusionCuller::queueQuery(size_t chunkIndex, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+    if (!m_states[chunkIndex].pending) {
+        m_queue.push_back({ chunkIndex, boxMin, boxMax });
+    }
+}
+
+size_t ChunkOcclusionCuller::submitQueries(const glm::mat4& viewProjection) {
+    unsigned int program = getBoxShaderProgram();
+    if (m_queue.empty() || program == 0) {
+        m_queue.clear();
+        return 0;
+    }
+    
+    // Test against the depth buffer without changing it
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDepthFunc(GL_LEQUAL);
+    
+    glUseProgram(program);
+    glUniformMatrix4fv(glGetUniformLocation(program, "viewProjection"), 1, GL_FALSE, glm::value_ptr(viewProjection));
+    GLint boxMinLocation = glGetUniformLocation(program, "boxMin");
+    GLint boxSizeLocation = glGetUniformLocation(program, "boxSize");
+    glBindVertexArray(getBoxVertexArray());
+    
+    for (const QueuedBox& box : m_queue) {
+        ChunkState& state = m_states[box.chunkIndex];
+        if (state.query == 0) {
+            glGenQueries(1, &state.query);
+        }
+        
+        glm::vec3 boxMin = box.min - glm::vec3(kBoxMargin);
+        glm::vec3 boxSize = box.max - box.min + glm::vec3(2.0f * kBoxMargin);
+        glUniform3fv(boxMinLocation, 1, glm::value_ptr(boxMin));
+        glUniform3fv(boxSizeLocation, 1, glm::value_ptr(boxSize));
+        
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, state.query);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, (void*)0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        state.pending = true;
+    }
+    
+    glBindVertexArray(0);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    
+    size_t issued = m_queue.size();
+    m_queue.clear();
+    return issued;
+}
+
+void ChunkOcclusionCuller::release() {
+    for (ChunkState& state : m_states) {
+        if (state.query != 0) {
+            glDeleteQueries(1, &state.query);
+        }
+        state = ChunkState();
+    }
+    m_queue.clear();
+}
+
+unsigned int ChunkOcclusionCuller::getBoxShaderProgram() {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + "/occlusion_box_vertex.glsl",
+        std::string(SHADER_DIR) + "/occlusion_box_fragment.glsl"
+    );
+}
+
+unsigned int ChunkOcclusionCuller::getBoxVertexArray() {
+    static unsigned int vao = 0;
+    
+    if (vao == 0) {
+        // Unit cube, scaled and placed by the shader
+        const float vertices[] = {
+            0.0f, 0.0f, 0.0f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f, 0.0f,   0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 1.0f,   1.0f, 0.0f, 1.0f,   1.0f, 1.0f, 1.0f,   0.0f, 1.0f, 1.0f
+        };
+        const unsigned char indices[] = {
+            0, 1, 2, 2, 3, 0,   // Back
+            4, 5, 6, 6, 7, 4,   // Front
+            0, 4, 7, 7, 3, 0,   // Left
+            1, 5, 6, 6, 2, 1,   // Right
+            0, 1, 5, 5, 4, 0,   // Bottom
+            3, 2, 6, 6, 7, 3    // Top
+        };
+        
+        unsigned int buffers[2];
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(2, buffers);
+        
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindVertexArray(0);
+    }
+    
+    return vao;
+}
+
+} // namespace Zenith
@@ -0,0 +1,62 @@
+#ifndef CHUNK_OCCLUSION_CULLER_H
+#define CHUNK_OCCLUSION_CULLER_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// Hardware occlusion culling with the previous frame's results. After a model's
+// chunks are drawn, each chunk's bounding box is drawn (no colour or depth writes)
+// inside an occlusion query; a chunk whose last finished query passed no samples is
+// skipped. Results are only read once available, so the CPU never waits on the GPU,
+// at the cost of a chunk that comes into view showing up a frame late.
+class ChunkOcclusionCuller {
+public:
+    ChunkOcclusionCuller();
+    
+    ChunkOcclusionCuller(const ChunkOcclusionCuller&) = delete;
+    ChunkOcclusionCuller& operator=(const ChunkOcclusionCuller&) = delete;
+    
+    // Track `chunkCount` chunks, indexed like the model's chunk list
+    void resize(size_t chunkCount);
+    
+    // Whether the chunk was hidden according to its latest finished query. Chunks
+    // containing the camera are never reported hidden: their box can't be tested.
+    bool isOccluded(size_t chunkIndex, const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::vec3& viewPos);
+    
+    // Test the chunk's box this frame, unless an earlier query is still in flight
+    void queueQuery(size_t chunkIndex, const glm::vec3& boxMin, const glm::vec3& boxMax);
+    
+    // Draw the queued boxes against the current depth buffer.
+    // Returns the number of queries issued.
+    size_t submitQueries(const glm::mat4& viewProjection);
+    
+    // Delete the queries, must be called while the context is alive
+    void release();
+    
+private:
+    struct ChunkState {
+        unsigned int query = 0;
+        bool pending = false;       // Issued, result not read yet
+        bool occluded = false;
+    };
+    
+    struct QueuedBox {
+        size_t chunkIndex;
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+    
+    // Shader and unit cube shared by every culler
+    static unsigned int getBoxShaderProgram();
+    static unsigned int getBoxVertexArray();
+    
+    std::vector<ChunkState> m_states;
+    std::vector<QueuedBox> m_queue;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_OCCLUSION_CULLER_H
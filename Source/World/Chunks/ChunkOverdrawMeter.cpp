@@ -0,0 +1,82 @@
+#include "ChunkOverdrawMeter.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace Zenith {
+
+ChunkOverdrawMeter::ChunkOverdrawMeter()
+    : m_active(-1), m_frame(0), m_resultFrame(0), m_samplesPassed(0), m_overdraw(0.0)
+{
+}
+
+void ChunkOverdrawMeter::begin() {
+    collect();
+    m_frame++;
+    
+    auto free = std::find_if(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return !slot.pending; });
+    if (free == m_slots.end()) {
+        m_active = -1;
+        return;
+    }
+    
+    // Multisampled targets count every covered sample
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    GLint samples = 0;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_SAMPLES, &samples);
+    
+    if (free->query == 0) {
+        glGenQueries(1, &free->query);
+    }
+    free->frame = m_frame;
+    free->viewportSamples = static_cast<uint64_t>(viewport[2]) * viewport[3] * std::max(samples, 1);
+    glBeginQuery(GL_SAMPLES_PASSED, free->query);
+    m_active = static_cast<int>(free - m_slots.begin());
+}
+
+void ChunkOverdrawMeter::end() {
+    if (m_active < 0) {
+        return;
+    }
+    
+    glEndQuery(GL_SAMPLES_PASSED);
+    m_slots[m_active].pending = true;
+    m_active = -1;
+}
+
+void ChunkOverdrawMeter::collect() {
+    for (Slot& slot : m_slots) {
+        if (!slot.pending) {
+            continue;
+        }
+        
+        GLuint available = 0;
+        glGetQueryObjectuiv(slot.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+        slot.pending = false;
+        
+        // Slots aren't visited in issue order, an older result mustn't replace a newer one
+        if (slot.frame < m_resultFrame) {
+            continue;
+        }
+        GLuint64 samplesPassed = 0;
+        glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &samplesPassed);
+        m_resultFrame = slot.frame;
+        m_samplesPassed = samplesPassed;
+        m_overdraw = slot.viewportSamples > 0 ? static_cast<double>(samplesPassed) / slot.viewportSamples : 0.0;
+    }
+}
+
+void ChunkOverdrawMeter::release() {
+    for (Slot& slot : m_slots) {
+        if (slot.query != 0) {
+            glDeleteQueries(1, &slot.query);
+        }
+        slot = Slot();
+    }
+    m_active = -1;
+}
+
+} // namespace Zenith
@@ -0,0 +1,60 @@
+#ifndef CHUNK_OVERDRAW_METER_H
+#define CHUNK_OVERDRAW_METER_H
+
+#include <array>
+#include <cstdint>
+
+namespace Zenith {
+
+// Measures the fragments the chunk shading passes write per viewport pixel, with
+// a GL_SAMPLES_PASSED query around them. Pixels left to the sky count as zero, so
+// the figure is only comparable between views covering as much of the screen; at
+// full coverage, anything over 1.0 is overdraw from surfaces drawn before the ones
+// hiding them. Fragments failing the depth test aren't counted: with early depth
+// testing they are never shaded. Like ChunkOcclusionCuller, results are only read once available, so the
+// figure trails the frame by a few frames and the CPU never waits on the GPU.
+//
+// Only one occlusion query can be active at a time, so the measured passes must
+// not contain other queries (submit the occlusion boxes after end()).
+class ChunkOverdrawMeter {
+public:
+    ChunkOverdrawMeter();
+    
+    ChunkOverdrawMeter(const ChunkOverdrawMeter&) = delete;
+    ChunkOverdrawMeter& operator=(const ChunkOverdrawMeter&) = delete;
+    
+    // Start counting, skipped when every query is still in flight
+    void begin();
+    void end();
+    
+    // Latest finished measurement: samples written per sample of the viewport
+    double getOverdraw() const { return m_overdraw; }
+    uint64_t getSamplesPassed() const { return m_samplesPassed; }
+    
+    // Delete the queries, must be called while the context is alive
+    void release();
+    
+private:
+    static constexpr int kQueryCount = 4;
+    
+    struct Slot {
+        unsigned int query = 0;
+        bool pending = false;
+        uint64_t frame = 0;         // When it was issued, to keep the newest result
+        uint64_t viewportSamples = 0;
+    };
+    
+    // Read back the finished queries
+    void collect();
+    
+    std::array<Slot, kQueryCount> m_slots;
+    int m_active;               // Slot counting between begin() and end(), -1 if none
+    uint64_t m_frame;
+    uint64_t m_resultFrame;
+    uint64_t m_samplesPassed;
+    double m_overdraw;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_OVERDRAW_METER_H
@@ -0,0 +1,80 @@
+#ifndef CHUNK_VERTEX_H
+#define CHUNK_VERTEX_H
+
+#include <cstdint>
+
+namespace Zenith {
+
+// Chunk vertices are two 32-bit words (8 bytes, against 32 for the float layout
+// Voxel uses), decoded in chunk_vertex.glsl:
+//
+//   data0  bits  0-4   x corner, 0..CHUNK_SIZE (block edges, not centres)
+//          bits  5-9   y corner
+//          bits 10-14  z corner
+//          bits 15-17  face, in Voxel order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT
+//          bits 18-19  ambient occlusion, 0 (darkest) .. 3 (unoccluded)
+//   data1  bits  0-15  layer in the block texture array
+//          bits 16-19  sky light, 0..15
+//          bits 20-23  block light, 0..15
+//
+// Texture coordinates are not stored: the shader projects the corner position on
+// the face plane, which also tiles the texture across downsampled LOD faces.
+struct ChunkVertex {
+    uint32_t data0;
+    uint32_t data1;
+};
+
+constexpr int CHUNK_VERTEX_MAX_AO = 3;
+constexpr int CHUNK_VERTEX_MAX_LIGHT = 15;
+
+inline ChunkVertex packChunkVertex(int x, int y, int z, int face, int ao, int layer,
+                                   int skyLight = CHUNK_VERTEX_MAX_LIGHT, int blockLight = 0) {
+    ChunkVertex vertex;
+    vertex.data0 = static_cast<uint32_t>(x & 31)
+                 | (static_cast<uint32_t>(y & 31) << 5)
+                 | (static_cast<uint32_t>(z & 31) << 10)
+                 | (static_cast<uint32_t>(face & 7) << 15)
+                 | (static_cast<uint32_t>(ao & 3) << 18);
+    vertex.data1 = static_cast<uint32_t>(layer & 0xFFFF)
+                 | (static_cast<uint32_t>(skyLight & 15) << 16)
+                 | (static_cast<uint32_t>(blockLight & 15) << 20);
+    return vertex;
+}
+
+// Face record for vertex pulling: one per visible face, read from a shader storage
+// buffer and expanded to a quad in chunk_face_vertex.glsl (no index buffer, 8 bytes
+// per face against 32 for four ChunkVertex):
+//
+//   data0  bits  0-14  minimum corner of the face's cell, 5 bits per axis
+//          bits 15-17  face, in Voxel order
+//          bits 18-19  log2 of the cell size (0 at full detail, 3 for 8x LOD cells)
+//          bits 20-27  ambient occlusion of the four corners, 2 bits each
+//          bit  28     split the quad along the 1-3 diagonal instead of 0-2
+//   data1  as ChunkVertex
+struct ChunkFace {
+    uint32_t data0;
+    uint32_t data1;
+};
+
+// Corner AO with all four corners unoccluded
+constexpr int CHUNK_FACE_NO_AO = 0xFF;
+
+inline ChunkFace packChunkFace(int x, int y, int z, int face, int sizeLog2, int layer, int cornerAo = CHUNK_FACE_NO_AO,
+                               bool flipped = false, int skyLight = CHUNK_VERTEX_MAX_LIGHT, int blockLight = 0) {
+    ChunkFace record;
+    record.data0 = static_cast<uint32_t>(x & 31)
+                 | (static_cast<uint32_t>(y & 31) << 5)
+                 | (static_cast<uint32_t>(z & 31) << 10)
+                 | (static_cast<uint32_t>(face & 7) << 15)
+                 | (static_cast<uint32_t>(sizeLog2 & 3) << 18)
+                 | (static_cast<uint32_t>(cornerAo & 0xFF) << 20)
+                 | (flipped ? (1u << 28) : 0u);
+    record.data1 = static_cast<uint32_t>(layer & 0xFFFF)
+                 | (static_cast<uint32_t>(skyLight & 15) << 16)
+                 | (static_cast<uint32_t>(blockLight & 15) << 20);
+    return record;
+}
+
+} // namespace Zenith
+
+#endif // CHUNK_VERTEX_H
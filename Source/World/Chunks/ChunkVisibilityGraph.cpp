@@ -0,0 +1,150 @@
+#include "ChunkVisibilityGraph.h"
+#include <cmath>
+
+namespace Zenith {
+
+namespace {
+
+// Step to the neighbouring chunk through each face
+const int kFaceSteps[6][3] = {
+    { 0,  1,  0},
+    { 0, -1,  0},
+    { 0,  0,  1},
+    { 0,  0, -1},
+    {-1,  0,  0},
+    { 1,  0,  0}
+};
+
+int oppositeFace(int face) {
+    return face ^ 1;
+}
+
+} // namespace
+
+uint16_t ChunkVisibilityGraph::computeConnectivity(const Chunk& chunk, const std::vector<BlockMaterial>& materials) {
+    if (chunk.isEmpty()) {
+        return ALL_CONNECTED;
+    }
+    
+    auto isOpen = [&](int index) {
+        uint16_t blockId = chunk.getBlock(index % CHUNK_SIZE, index / (CHUNK_SIZE * CHUNK_SIZE),
+                                          (index / CHUNK_SIZE) % CHUNK_SIZE);
+        return blockId == 0 || (blockId < materials.size() && !materials[blockId].opaque);
+    };
+    
+    m_visited.assign(CHUNK_VOLUME, 0);
+    uint16_t connectivity = 0;
+    
+    for (int start = 0; start < CHUNK_VOLUME && connectivity != ALL_CONNECTED; start++) {
+        if (m_visited[start] || !isOpen(start)) {
+            continue;
+        }
+        
+        // Flood one open region and note the faces it reaches
+        unsigned int faces = 0;
+        m_visited[start] = 1;
+        m_stack.assign(1, start);
+        
+        while (!m_stack.empty()) {
+            int index = m_stack.back();
+            m_stack.pop_back();
+            
+            int x = index % CHUNK_SIZE;
+            int z = (index / CHUNK_SIZE) % CHUNK_SIZE;
+            int y = index / (CHUNK_SIZE * CHUNK_SIZE);
+            if (y == CHUNK_SIZE - 1) faces |= 1u << 0;
+            if (y == 0)              faces |= 1u << 1;
+            if (z == CHUNK_SIZE - 1) faces |= 1u << 2;
+            if (z == 0)              faces |= 1u << 3;
+            if (x == 0)              faces |= 1u << 4;
+            if (x == CHUNK_SIZE - 1) faces |= 1u << 5;
+            
+            for (const int* step : kFaceSteps) {
+                int nx = x + step[0];
+                int ny = y + step[1];
+                int nz = z + step[2];
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_SIZE || ny >= CHUNK_SIZE || nz >= CHUNK_SIZE) {
+                    continue;
+                }
+                
+                int neighbour = Chunk::index(nx, ny, nz);
+                if (!m_visited[neighbour] && isOpen(neighbour)) {
+                    m_visited[neighbour] = 1;
+                    m_stack.push_back(neighbour);
+                }
+            }
+        }
+        
+        for (int a = 0; a < 6; a++) {
+            for (int b = a + 1; b < 6; b++) {
+                if ((faces & (1u << a)) && (faces & (1u << b))) {
+                    connectivity |= pairBit(a, b);
+                }
+            }
+        }
+    }
+    
+    return connectivity;
+}
+
+void ChunkVisibilityGraph::findVisible(const std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                                       const glm::vec3& modelPosition, const glm::vec3& viewPos, const Frustum& frustum,
+                                       std::vector<uint8_t>& visible) {
+    // Blocks are centred on their coordinates, chunk c spans c * 16 - 0.5 to c * 16 + 15.5
+    glm::vec3 local = viewPos - modelPosition + glm::vec3(0.5f);
+    glm::ivec3 camera(static_cast<int>(std::floor(local.x / CHUNK_SIZE)),
+                      static_cast<int>(std::floor(local.y / CHUNK_SIZE)),
+                      static_cast<int>(std::floor(local.z / CHUNK_SIZE)));
+    
+    if (glm::any(glm::lessThan(camera, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(camera, gridSize))) {
+        visible.assign(chunks.size(), 1);
+        return;
+    }
+    
+    auto chunkIndex = [&gridSize](const glm::ivec3& coord) {
+        return (coord.y * gridSize.z + coord.z) * gridSize.x + coord.x;
+    };
+    
+    visible.assign(chunks.size(), 0);
+    m_queue.clear();
+    
+    int start = chunkIndex(camera);
+    visible[start] = 1;
+    m_queue.push_back({ start, -1, 0 });
+    
+    for (size_t head = 0; head < m_queue.size(); head++) {
+        SearchNode node = m_queue[head];
+        const Chunk& chunk = *chunks[node.chunkIndex];
+        uint16_t connectivity = chunk.getFaceConnectivity();
+        
+        for (int face = 0; face < 6; face++) {
+            // Going back the way the search came can't reveal anything new
+            if (node.directions & (1u << oppositeFace(face))) {
+                continue;
+            }
+            if (node.entryFace >= 0 && !connects(connectivity, node.entryFace, face)) {
+                continue;
+            }
+            
+            glm::ivec3 coord = chunk.getCoord() + glm::ivec3(kFaceSteps[face][0], kFaceSteps[face][1], kFaceSteps[face][2]);
+            if (glm::any(glm::lessThan(coord, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(coord, gridSize))) {
+                continue;
+            }
+            
+            int neighbour = chunkIndex(coord);
+            if (visible[neighbour]) {
+                continue;
+            }
+            
+            glm::vec3 chunkMin = modelPosition + glm::vec3(coord * CHUNK_SIZE) - glm::vec3(0.5f);
+            if (!frustum.intersectsAABB(chunkMin, chunkMin + glm::vec3(static_cast<float>(CHUNK_SIZE)))) {
+                continue;
+            }
+            
+            visible[neighbour] = 1;
+            m_queue.push_back({ neighbour, oppositeFace(face), static_cast<uint8_t>(node.directions | (1u << face)) });
+        }
+    }
+}
+
+} // namespace Zenith
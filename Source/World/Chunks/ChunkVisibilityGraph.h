@@ -0,0 +1,66 @@
+#ifndef CHUNK_VISIBILITY_GRAPH_H
+#define CHUNK_VISIBILITY_GRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Blocks/BlockMaterial.h"
+#include "Utils/Frustum.h"
+#include "Chunk.h"
+
+namespace Zenith {
+
+// Cave culling from chunk face connectivity. When a chunk is meshed, a flood fill
+// through its non-opaque cells records which of its six faces can see each other.
+// Each frame a breadth-first search walks from the camera's chunk through those
+// links; chunks it never reaches (sealed caves, underground rock) can't be seen
+// through any opening and are skipped. Everything is CPU side, no GPU readback.
+//
+// Faces use Voxel order: TOP, BOTTOM, FRONT, BACK, LEFT, RIGHT.
+class ChunkVisibilityGraph {
+public:
+    // One bit per unordered pair of different faces (15 pairs)
+    static constexpr uint16_t ALL_CONNECTED = 0x7FFF;
+    
+    static bool connects(uint16_t connectivity, int faceA, int faceB) {
+        return (connectivity & pairBit(faceA, faceB)) != 0;
+    }
+    
+    // Flood fill a chunk. Palette indices with no material count as opaque.
+    uint16_t computeConnectivity(const Chunk& chunk, const std::vector<BlockMaterial>& materials);
+    
+    // Mark the chunks reachable from the camera. chunks is a model's chunk list
+    // (x fastest, then z, then y) of gridSize chunks; the search only enters chunks
+    // inside the frustum. A camera outside the grid marks every chunk reachable.
+    void findVisible(const std::vector<std::unique_ptr<Chunk>>& chunks, const glm::ivec3& gridSize,
+                     const glm::vec3& modelPosition, const glm::vec3& viewPos, const Frustum& frustum,
+                     std::vector<uint8_t>& visible);
+    
+private:
+    static uint16_t pairBit(int faceA, int faceB) {
+        if (faceA > faceB) {
+            int swap = faceA;
+            faceA = faceB;
+            faceB = swap;
+        }
+        // Pairs (0,1) .. (0,5), (1,2) .. (1,5), ...
+        static const int kPairBase[6] = { 0, 4, 7, 9, 10, 10 };
+        return faceA == faceB ? 0 : static_cast<uint16_t>(1u << (kPairBase[faceA] + faceB - 1));
+    }
+    
+    struct SearchNode {
+        int chunkIndex;
+        int entryFace;          // Face the search came in through, -1 for the camera chunk
+        uint8_t directions;     // Directions taken so far, the search never turns back
+    };
+    
+    // Scratch reused by every call
+    std::vector<uint8_t> m_visited;
+    std::vector<int> m_stack;
+    std::vector<SearchNode> m_queue;
+};
+
+} // namespace Zenith
+
+#endif // CHUNK_VISIBILITY_GRAPH_H
@@ -0,0 +1,214 @@
+#include "ShadowMap.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace Zenith {
+
+ShadowMap::ShadowMap()
+    : m_framebuffer(0), m_depthTexture(0), m_resolution(0), m_cascadeCount(0),
+      m_frame(0), m_invalidated(true), m_lightDir(0.0f)
+{
+}
+
+bool ShadowMap::initialize(int resolution, int cascadeCount) {
+    release();
+    m_resolution = std::max(resolution, 1);
+    m_cascadeCount = std::clamp(cascadeCount, 1, MAX_SHADOW_CASCADES);
+    m_invalidated = true;
+
+    glGenTextures(1, &m_depthTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, m_resolution, m_resolution, m_cascadeCount, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+    // The shader filters with its own 5x5 taps, so plain nearest lookups. Outside
+    // the map reads as the far plane: lit.
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float border[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+
+    // Each pass attaches its own layer, the first one is enough to check completeness
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depthTexture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete) {
+        std::cerr << "Shadow map framebuffer is incomplete (" << m_cascadeCount << " cascades of "
+                  << m_resolution << "x" << m_resolution << ")" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void ShadowMap::update(const glm::vec3& lightDir, const ShadowCamera& camera,
+                       const glm::vec3& casterMin, const glm::vec3& casterMax) {
+    glm::vec3 direction = glm::normalize(lightDir);
+    if (direction != m_lightDir) {
+        m_lightDir = direction;
+        m_invalidated = true;
+    }
+
+    // Cascade 0 every frame, the others one per frame in turn (every other frame
+    // when there is only one of them)
+    int period = std::max(m_cascadeCount - 1, 2);
+    for (int cascade = 0; cascade < m_cascadeCount; cascade++) {
+        m_cascades[cascade].due = m_invalidated || cascade == 0
+                               || static_cast<int>(m_frame % period) == (cascade - 1) % period;
+    }
+    m_invalidated = false;
+    m_frame++;
+
+    glm::vec3 casterCorners[8];
+    for (int corner = 0; corner < 8; corner++) {
+        casterCorners[corner] = glm::vec3((corner & 1) ? casterMax.x : casterMin.x,
+                                          (corner & 2) ? casterMax.y : casterMin.y,
+                                          (corner & 4) ? casterMax.z : casterMin.z);
+    }
+
+    // Past the farthest caster corner there is nothing to shadow
+    glm::mat4 cameraToWorld = glm::inverse(camera.view);
+    glm::vec3 cameraPos(cameraToWorld[3]);
+    float worldReach = 0.0f;
+    for (const glm::vec3& corner : casterCorners) {
+        worldReach = std::max(worldReach, glm::length(corner - cameraPos));
+    }
+    float nearPlane = camera.nearPlane;
+    float farPlane = std::max(std::min(camera.farPlane, worldReach), nearPlane * 2.0f);
+
+    // A fixed origin keeps texel snapping stable while the camera moves. Any up
+    // vector not parallel to the light works.
+    glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightView = glm::lookAt(-direction, glm::vec3(0.0f), up);
+
+    float casterLow = std::numeric_limits<float>::max();
+    float casterHigh = std::numeric_limits<float>::lowest();
+    for (const glm::vec3& corner : casterCorners) {
+        float depth = (lightView * glm::vec4(corner, 1.0f)).z;
+        casterLow = std::min(casterLow, depth);
+        casterHigh = std::max(casterHigh, depth);
+    }
+
+    float tanHalfFov = std::tan(camera.fovY * 0.5f);
+    float sliceNear = nearPlane;
+    for (int cascade = 0; cascade < m_cascadeCount; cascade++) {
+        // Practical split scheme: mostly logarithmic, pulled towards uniform so the
+        // first cascade isn't tiny
+        float fraction = static_cast<float>(cascade + 1) / m_cascadeCount;
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, fraction);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * fraction;
+        float sliceFar = kSplitBlend * logSplit + (1.0f - kSplitBlend) * uniformSplit;
+
+        float slice[2] = { sliceNear, sliceFar };
+        sliceNear = sliceFar;
+
+        Cascade& state = m_cascades[cascade];
+        if (!state.due) {
+            continue;
+        }
+        state.splitDistance = sliceFar;
+
+        // Bounding sphere of the slice: its size doesn't change as the camera turns,
+        // so shadow edges don't shimmer
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int corner = 0; corner < 8; corner++) {
+            float depth = slice[corner >> 2];
+            float halfHeight = depth * tanHalfFov;
+            float halfWidth = halfHeight * camera.aspect;
+            glm::vec4 viewCorner((corner & 1) ? halfWidth : -halfWidth,
+                                 (corner & 2) ? halfHeight : -halfHeight, -depth, 1.0f);
+            corners[corner] = glm::vec3(cameraToWorld * viewCorner);
+            center += corners[corner] / 8.0f;
+        }
+        float radius = 0.0f;
+        for (const glm::vec3& corner : corners) {
+            radius = std::max(radius, glm::length(corner - center));
+        }
+        radius = std::ceil(radius);
+
+        // Move the frustum in whole texels so static geometry keeps its shadow texels
+        float texelSize = 2.0f * radius / m_resolution;
+        glm::vec3 lightCenter(lightView * glm::vec4(center, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+        // The view looks down -z, so the nearest geometry has the largest z. A block
+        // of margin keeps the boundary faces inside.
+        float nearDepth = -std::max(casterHigh, lightCenter.z + radius) - 1.0f;
+        float farDepth = -std::min(casterLow, lightCenter.z - radius) + 1.0f;
+        glm::mat4 lightProjection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius,
+                                               lightCenter.y - radius, lightCenter.y + radius,
+                                               nearDepth, farDepth);
+
+        state.lightSpaceMatrix = lightProjection * lightView;
+    }
+}
+
+int ShadowMap::getCascadesDue() const {
+    int count = 0;
+    for (int cascade = 0; cascade < m_cascadeCount; cascade++) {
+        count += m_cascades[cascade].due ? 1 : 0;
+    }
+    return count;
+}
+
+void ShadowMap::beginPass(int cascade) const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depthTexture, 0, cascade);
+    glViewport(0, 0, m_resolution, m_resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+}
+
+void ShadowMap::endPass(int viewportWidth, int viewportHeight) const {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, viewportWidth, viewportHeight);
+}
+
+void ShadowMap::bind(unsigned int program, int unit) const {
+    glm::mat4 matrices[MAX_SHADOW_CASCADES];
+    float splits[MAX_SHADOW_CASCADES];
+    for (int cascade = 0; cascade < m_cascadeCount; cascade++) {
+        matrices[cascade] = m_cascades[cascade].lightSpaceMatrix;
+        splits[cascade] = m_cascades[cascade].splitDistance;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthTexture);
+    glUniform1i(glGetUniformLocation(program, "shadowMap"), unit);
+    glUniformMatrix4fv(glGetUniformLocation(program, "lightSpaceMatrices"), m_cascadeCount, GL_FALSE,
+                       glm::value_ptr(matrices[0]));
+    glUniform1fv(glGetUniformLocation(program, "cascadeSplits"), m_cascadeCount, splits);
+    glUniform1i(glGetUniformLocation(program, "cascadeCount"), m_cascadeCount);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void ShadowMap::release() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_depthTexture != 0) {
+        glDeleteTextures(1, &m_depthTexture);
+        m_depthTexture = 0;
+    }
+}
+
+} // namespace Zenith
@@ -0,0 +1,115 @@
+#ifndef SHADOW_MAP_H
+#define SHADOW_MAP_H
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// Most cascades a ShadowMap can have, must match MAX_SHADOW_CASCADES in the shaders
+constexpr int MAX_SHADOW_CASCADES = 4;
+
+// Camera the cascades are fitted to
+struct ShadowCamera {
+    glm::mat4 view{1.0f};
+    float fovY = 1.0f;          // Vertical field of view, radians
+    float aspect = 1.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 1000.0f;
+};
+
+// Cascaded depth maps of the scene seen from the directional light, one layer of
+// a texture array per cascade, sampled by the chunk shaders built with
+// ENABLE_SHADOWS. The view range is split into slices growing with distance, and
+// each slice gets an orthographic light frustum of the same resolution, so near
+// shadows stay sharp and far ones still exist.
+//
+// Cascade 0 is re-rendered every frame; the others take turns, so a frame renders
+// at most two cascades. Cascades keep the matrix they were rendered with until
+// their next turn. A frame looks like:
+//
+//   shadowMap.update(lightDir, camera, worldMin, worldMax);
+//   for (int cascade = 0; cascade < shadowMap.getCascadeCount(); cascade++) {
+//       if (shadowMap.isCascadeDue(cascade)) {
+//           shadowMap.beginPass(cascade);
+//           model.renderDepth(shadowMap.getLightSpaceMatrix(cascade), viewPos);
+//           shadowMap.endPass(framebufferWidth, framebufferHeight);
+//       }
+//   }
+//
+// Like the other GL owners the destructor makes no GL calls, call release().
+class ShadowMap {
+public:
+    ShadowMap();
+    ~ShadowMap() = default;
+
+    ShadowMap(const ShadowMap&) = delete;
+    ShadowMap& operator=(const ShadowMap&) = delete;
+
+    // Create (or recreate) the depth texture array and framebuffer. cascadeCount is
+    // clamped to 1..MAX_SHADOW_CASCADES. Returns false if the framebuffer is incomplete.
+    bool initialize(int resolution, int cascadeCount);
+    bool isInitialized() const { return m_framebuffer != 0; }
+
+    // Split the camera's view range and fit a light frustum to each slice. Along
+    // the light every frustum also covers the caster box (world space), so blocks
+    // outside the view still shadow what is in it. Picks the cascades due this frame.
+    void update(const glm::vec3& lightDir, const ShadowCamera& camera,
+                const glm::vec3& casterMin, const glm::vec3& casterMax);
+
+    // Re-render every cascade on the next update(), e.g. after the world changed
+    void invalidate() { m_invalidated = true; }
+
+    int getCascadeCount() const { return m_cascadeCount; }
+    bool isCascadeDue(int cascade) const { return m_cascades[cascade].due; }
+    int getCascadesDue() const;
+
+    // World space to the light's clip space of a cascade, for the depth pass and the lookups
+    const glm::mat4& getLightSpaceMatrix(int cascade) const { return m_cascades[cascade].lightSpaceMatrix; }
+
+    // View depth where a cascade ends
+    float getSplitDistance(int cascade) const { return m_cascades[cascade].splitDistance; }
+
+    // Bind the framebuffer to a cascade's layer, set the viewport to the map and
+    // clear it. Depth is offset by the slope so flat faces don't shadow themselves.
+    void beginPass(int cascade) const;
+
+    // Back to the default framebuffer with the given viewport
+    void endPass(int viewportWidth, int viewportHeight) const;
+
+    // Bind the depth texture array to a texture unit and set the "shadowMap",
+    // "lightSpaceMatrices", "cascadeSplits" and "cascadeCount" uniforms of the
+    // program in use
+    void bind(unsigned int program, int unit) const;
+
+    unsigned int getDepthTexture() const { return m_depthTexture; }
+    int getResolution() const { return m_resolution; }
+
+    // Delete the GL objects, must be called while the context is alive
+    void release();
+
+private:
+    struct Cascade {
+        glm::mat4 lightSpaceMatrix{1.0f};
+        float splitDistance = 0.0f;
+        bool due = false;
+    };
+
+    // Share of logarithmic against uniform spacing in the split distances
+    static constexpr float kSplitBlend = 0.75f;
+
+    unsigned int m_framebuffer;
+    unsigned int m_depthTexture;
+    int m_resolution;
+    int m_cascadeCount;
+    std::array<Cascade, MAX_SHADOW_CASCADES> m_cascades;
+
+    // Drives the turns of the far cascades
+    unsigned int m_frame;
+    bool m_invalidated;
+    glm::vec3 m_lightDir;
+};
+
+} // namespace Zenith
+
+#endif // SHADOW_MAP_H
@@ -1,12 +1,48 @@
 #include "BaseModel.h"
+#include "Blocks/BlockTextureArray.h"
+#include "Blocks/Lightmap.h"
+#include "World/Chunks/ChunkDrawBatcher.h"
+#include "Utils/Frustum.h"
+#include "Utils/ShaderUtils.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 namespace Zenith {
 
 BaseModel::BaseModel(int p, int q, int r)
-    : m_width(p), m_height(q), m_depth(r), m_position(0.0f, 0.0f, 0.0f)
+    : m_width(p), m_height(q), m_depth(r), m_position(0.0f, 0.0f, 0.0f),
+      m_chunksX((p + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      m_chunksY((q + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      m_chunksZ((r + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      m_voxelCount(0),
+      m_blockRegistry(nullptr),
+      m_lightingStale(true),
+      m_occlusionCulling(false),
+      m_visibilityCulling(false),
+      m_shadowMap(nullptr),
+      m_ambientStrength(0.3f),
+      m_shaderFeatures(ShaderUtils::AO | ShaderUtils::SPECULAR),
+      m_separatePasses(true),
+      m_leavesMode(LeavesMode::FANCY),
+      m_depthPrePass(false),
+      m_debugView(ChunkDebugView::NONE)
 {
-    // Initialize with empty dimensions
+    // Palette index 0 is reserved for empty cells
+    m_palette.push_back("");
+
+    m_chunks.reserve(static_cast<size_t>(m_chunksX) * m_chunksY * m_chunksZ);
+    for (int cy = 0; cy < m_chunksY; cy++) {
+        for (int cz = 0; cz < m_chunksZ; cz++) {
+            for (int cx = 0; cx < m_chunksX; cx++) {
+                m_chunks.push_back(std::make_unique<Chunk>(glm::ivec3(cx, cy, cz)));
+            }
+        }
+    }
 }
 
 bool BaseModel::addVoxel(int x, int y, int z, const std::string& blockType) {
@@ -14,9 +50,15 @@ bool BaseModel::addVoxel(int x, int y, int z, const std::string& blockType) {
         std::cerr << "Error: Attempted to add voxel outside model bounds (" << x << ", " << y << ", " << z << ")" << std::endl;
         return false;
     }
-    
+
+    // AIR is the registry's empty block, storing it just clears the cell
+    if (blockType.empty() || blockType == "AIR") {
+        setBlockId(x, y, z, 0);
+        return true;
+    }
+
     // Add or update the block at this position
-    m_blocks[VoxelPosition(x, y, z)] = blockType;
+    setBlockId(x, y, z, getPaletteId(blockType));
     return true;
 }
 
@@ -24,16 +66,13 @@ bool BaseModel::removeVoxel(int x, int y, int z) {
     if (!isWithinBounds(x, y, z)) {
         return false;
     }
-    
-    auto it = m_blocks.find(VoxelPosition(x, y, z));
-    if (it != m_blocks.end()) {
-        m_blocks.erase(it);
-        // Also remove the voxel object if it exists
-        m_voxels.erase(VoxelPosition(x, y, z));
-        return true;
+
+    if (getBlockId(x, y, z) == 0) {
+        return false; // No voxel at this position
     }
-    
-    return false; // No voxel at this position
+
+    setBlockId(x, y, z, 0);
+    return true;
 }
 
 bool BaseModel::isWithinBounds(int x, int y, int z) const {
@@ -41,16 +80,26 @@ bool BaseModel::isWithinBounds(int x, int y, int z) const {
 }
 
 std::string BaseModel::getBlockType(int x, int y, int z) const {
+    // Out-of-bounds and empty positions both map to palette entry 0, the empty string
+    return m_palette[getBlockId(x, y, z)];
+}
+
+uint16_t BaseModel::getBlockId(int x, int y, int z) const {
     if (!isWithinBounds(x, y, z)) {
-        return ""; // Return empty string for out-of-bounds positions
+        return 0;
     }
-    
-    auto it = m_blocks.find(VoxelPosition(x, y, z));
-    if (it != m_blocks.end()) {
-        return it->second;
+
+    const Chunk& chunk = *m_chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+    return chunk.getBlock(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE);
+}
+
+uint8_t BaseModel::getLight(int x, int y, int z) const {
+    if (x < 0 || y < 0 || z < 0 || x >= m_chunksX * CHUNK_SIZE || y >= m_chunksY * CHUNK_SIZE || z >= m_chunksZ * CHUNK_SIZE) {
+        return CHUNK_FULL_SKY_LIGHT;
     }
-    
-    return ""; // No block at this position
+
+    const Chunk& chunk = *m_chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+    return chunk.getLight(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE);
 }
 
 void BaseModel::setPosition(const glm::vec3& position) {
@@ -67,84 +116,843 @@ void BaseModel::getDimensions(int& p, int& q, int& r) const {
     r = m_depth;
 }
 
+void BaseModel::getChunkGridSize(int& x, int& y, int& z) const {
+    x = m_chunksX;
+    y = m_chunksY;
+    z = m_chunksZ;
+}
+
+const Chunk& BaseModel::getChunk(int cx, int cy, int cz) const {
+    return *m_chunks[chunkIndex(cx, cy, cz)];
+}
+
+uint16_t BaseModel::getPaletteId(const std::string& blockType) {
+    auto it = m_paletteLookup.find(blockType);
+    if (it != m_paletteLookup.end()) {
+        return it->second;
+    }
+
+    uint16_t blockId = static_cast<uint16_t>(m_palette.size());
+    m_palette.push_back(blockType);
+    m_paletteLookup[blockType] = blockId;
+    return blockId;
+}
+
+void BaseModel::setBlockId(int x, int y, int z, uint16_t blockId) {
+    Chunk& chunk = *m_chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+    uint16_t previous = chunk.setBlock(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE, blockId);
+    if (previous == blockId) {
+        return;
+    }
+
+    if (previous == 0) {
+        m_voxelCount++;
+    } else if (blockId == 0) {
+        m_voxelCount--;
+    }
+
+    markDirtyAround(x, y, z);
+    if (!m_lightingStale) {
+        m_lightEngine.queueBlockChange(glm::ivec3(x, y, z));
+    }
+}
+
+void BaseModel::markDirtyAround(int x, int y, int z) {
+    int cx = x / CHUNK_SIZE, cy = y / CHUNK_SIZE, cz = z / CHUNK_SIZE;
+    int lx = x % CHUNK_SIZE, ly = y % CHUNK_SIZE, lz = z % CHUNK_SIZE;
+
+    // A block on a chunk border is also visible to the meshes of the adjacent chunks
+    int minX = (lx == 0 && cx > 0) ? cx - 1 : cx;
+    int maxX = (lx == CHUNK_SIZE - 1 && cx < m_chunksX - 1) ? cx + 1 : cx;
+    int minY = (ly == 0 && cy > 0) ? cy - 1 : cy;
+    int maxY = (ly == CHUNK_SIZE - 1 && cy < m_chunksY - 1) ? cy + 1 : cy;
+    int minZ = (lz == 0 && cz > 0) ? cz - 1 : cz;
+    int maxZ = (lz == CHUNK_SIZE - 1 && cz < m_chunksZ - 1) ? cz + 1 : cz;
+
+    for (int ny = minY; ny <= maxY; ny++) {
+        for (int nz = minZ; nz <= maxZ; nz++) {
+            for (int nx = minX; nx <= maxX; nx++) {
+                markChunkDirty(chunkIndex(nx, ny, nz));
+            }
+        }
+    }
+}
+
+void BaseModel::markChunkDirty(size_t chunkIndex) {
+    Chunk& chunk = *m_chunks[chunkIndex];
+    if (!chunk.isDirty()) {
+        chunk.setDirty(true);
+        m_dirtyChunks.push_back(chunkIndex);
+    }
+}
+
 bool BaseModel::createVoxelObjects(const BlockRegistryReader& blockRegistry) {
-    // Clear any existing voxel objects
-    m_voxels.clear();
-    
-    // Iterate through all blocks in the model
-    for (const auto& [pos, blockType] : m_blocks) {
-        // Skip AIR blocks
-        if (blockType == "AIR") {
-            continue;
+    // Re-resolve every material against the (possibly different) registry
+    m_blockRegistry = &blockRegistry;
+    m_materials.clear();
+    m_lightingStale = true;
+
+    // Remesh everything once
+    for (size_t i = 0; i < m_chunks.size(); i++) {
+        if (!m_chunks[i]->isEmpty() || !m_chunks[i]->getMesh().isEmpty()) {
+            markChunkDirty(i);
         }
-        
-        // Get textures for this block type
-        const BlockTextures* textures = blockRegistry.getBlockTextures(blockType);
+    }
+
+    rebuildDirtyChunks();
+    return true;
+}
+
+bool BaseModel::setMeshLayout(ChunkMeshLayout layout) {
+    if (layout == m_mesher.getLayout()) {
+        return true;
+    }
+
+    if (layout == ChunkMeshLayout::FACE_RECORDS && !ChunkMesh::isFacePullingSupported()) {
+        std::cerr << "Error: Vertex pulling needs OpenGL 4.3, keeping vertex buffers" << std::endl;
+        return false;
+    }
+
+    m_mesher.setLayout(layout);
+    for (size_t i = 0; i < m_chunks.size(); i++) {
+        markChunkDirty(i);
+    }
+    return true;
+}
+
+void BaseModel::setLeavesMode(LeavesMode mode) {
+    if (mode == m_leavesMode) {
+        return;
+    }
+
+    // Leaves only change how they are meshed, light goes through them either way
+    m_leavesMode = mode;
+    m_materials.clear();
+    for (size_t i = 0; i < m_chunks.size(); i++) {
+        if (!m_chunks[i]->isEmpty()) {
+            markChunkDirty(i);
+        }
+    }
+}
+
+void BaseModel::resolveMaterials() {
+    for (size_t blockId = m_materials.size(); blockId < m_palette.size(); blockId++) {
+        BlockMaterial material;
+        const std::string& blockType = m_palette[blockId];
+
+        const BlockTextures* textures = blockId == 0 ? nullptr : m_blockRegistry->getBlockTextures(blockType);
         if (!textures) {
-            std::cerr << "Error: Could not find textures for block type: " << blockType << std::endl;
+            if (blockId != 0) {
+                std::cerr << "Error: Could not find textures for block type: " << blockType << std::endl;
+            }
+            material.opaque = false;
+            material.visible = false;
+            m_materials.push_back(material);
             continue;
         }
+
+        bool leaves = m_blockRegistry->isLeaves(blockType);
+        bool solidLeaves = leaves && m_leavesMode == LeavesMode::FAST;
+
+        BlockTextureArray& textureArray = BlockTextureArray::shared();
+        material.faceLayers = {
+            textureArray.getLayer(textures->top, solidLeaves),
+            textureArray.getLayer(textures->bottom, solidLeaves),
+            textureArray.getLayer(textures->front, solidLeaves),
+            textureArray.getLayer(textures->back, solidLeaves),
+            textureArray.getLayer(textures->left, solidLeaves),
+            textureArray.getLayer(textures->right, solidLeaves)
+        };
+        material.opaque = !m_blockRegistry->isTransparent(blockType);
+        material.solid = solidLeaves;
+        material.cutout = leaves && !material.opaque && !solidLeaves;
+        material.translucent = !leaves && !material.opaque;
+        material.lightEmission = static_cast<uint8_t>(m_blockRegistry->getLightEmission(blockType));
+        m_materials.push_back(material);
+    }
+}
+
+void BaseModel::updateLighting() {
+    glm::ivec3 gridSize(m_chunksX, m_chunksY, m_chunksZ);
+
+    if (m_lightingStale) {
+        m_lightEngine.computeAll(m_chunks, gridSize, m_materials);
+        m_lightingStale = false;
+
+        for (size_t i = 0; i < m_chunks.size(); i++) {
+            if (!m_chunks[i]->isEmpty()) {
+                markChunkDirty(i);
+            }
+        }
+        return;
+    }
+
+    if (m_lightEngine.hasQueuedChanges()) {
+        m_relitChunks.clear();
+        m_lightEngine.update(m_chunks, gridSize, m_materials, m_relitChunks);
+        for (size_t index : m_relitChunks) {
+            markChunkDirty(index);
+        }
+    }
+}
+
+void BaseModel::gatherPaddedBlocks(const Chunk& chunk) {
+    m_paddedBlocks.resize(PADDED_CHUNK_VOLUME);
+    m_paddedLight.resize(PADDED_CHUNK_VOLUME);
+    glm::ivec3 origin = chunk.getOrigin();
+
+    for (int y = -1; y <= CHUNK_SIZE; y++) {
+        for (int z = -1; z <= CHUNK_SIZE; z++) {
+            bool borderRow = y < 0 || y == CHUNK_SIZE || z < 0 || z == CHUNK_SIZE;
+            for (int x = -1; x <= CHUNK_SIZE; x++) {
+                // Interior cells come straight from the chunk, only the border needs a lookup
+                bool border = borderRow || x < 0 || x == CHUNK_SIZE;
+                int index = ChunkMesher::paddedIndex(x, y, z);
+                if (border) {
+                    m_paddedBlocks[index] = getBlockId(origin.x + x, origin.y + y, origin.z + z);
+                    m_paddedLight[index] = getLight(origin.x + x, origin.y + y, origin.z + z);
+                } else {
+                    m_paddedBlocks[index] = chunk.getBlock(x, y, z);
+                    m_paddedLight[index] = chunk.getLight(x, y, z);
+                }
+            }
+        }
+    }
+}
+
+void BaseModel::gatherLodBlocks(const Chunk& chunk, int lod) {
+    int scale = 1 << lod;
+    int size = CHUNK_SIZE / scale;
+    m_paddedBlocks.resize(static_cast<size_t>(size + 2) * (size + 2) * (size + 2));
+    m_paddedLight.resize(m_paddedBlocks.size());
+    glm::ivec3 origin = chunk.getOrigin();
+
+    // Block counts of the cell being voted on, in the order first seen
+    std::vector<std::pair<uint16_t, int>> votes;
+
+    for (int cy = -1; cy <= size; cy++) {
+        for (int cz = -1; cz <= size; cz++) {
+            for (int cx = -1; cx <= size; cx++) {
+                bool border = cx < 0 || cy < 0 || cz < 0 || cx == size || cy == size || cz == size;
+                votes.clear();
+                int filled = 0;
+                int skyLight = 0;
+                int blockLight = 0;
+
+                // Top down, so the surface block wins ties (grass over dirt)
+                for (int y = cy * scale + scale - 1; y >= cy * scale; y--) {
+                    for (int z = cz * scale; z < cz * scale + scale; z++) {
+                        for (int x = cx * scale; x < cx * scale + scale; x++) {
+                            uint16_t blockId = border
+                                ? getBlockId(origin.x + x, origin.y + y, origin.z + z)
+                                : chunk.getBlock(x, y, z);
+                            uint8_t light = border
+                                ? getLight(origin.x + x, origin.y + y, origin.z + z)
+                                : chunk.getLight(x, y, z);
+                            skyLight = std::max(skyLight, light >> 4);
+                            blockLight = std::max(blockLight, light & 15);
+                            if (blockId == 0) {
+                                continue;
+                            }
+
+                            filled++;
+                            auto it = std::find_if(votes.begin(), votes.end(),
+                                                   [blockId](const std::pair<uint16_t, int>& vote) { return vote.first == blockId; });
+                            if (it == votes.end()) {
+                                votes.emplace_back(blockId, 1);
+                            } else {
+                                it->second++;
+                            }
+                        }
+                    }
+                }
+
+                uint16_t winner = 0;
+                if (filled * 2 >= scale * scale * scale) {
+                    int best = 0;
+                    for (const auto& vote : votes) {
+                        if (vote.second > best) {
+                            best = vote.second;
+                            winner = vote.first;
+                        }
+                    }
+                }
+                int index = ChunkMesher::paddedIndex(cx, cy, cz, size);
+                m_paddedBlocks[index] = winner;
+                m_paddedLight[index] = static_cast<uint8_t>((skyLight << 4) | blockLight);
+            }
+        }
+    }
+}
+
+bool BaseModel::rebuildDirtyChunks() {
+    if (!m_blockRegistry || m_dirtyChunks.empty()) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    resolveMaterials();
+    updateLighting();
+    m_lastRebuildStats.uploadedBytes = 0;
+
+    for (size_t index : m_dirtyChunks) {
+        Chunk& chunk = *m_chunks[index];
+        chunk.setDirty(false);
+
+        ChunkMeshData& translucentData = chunk.getTranslucentData();
+        if (chunk.isEmpty()) {
+            m_meshData.clear();
+            m_cutoutMeshData.clear();
+            translucentData.clear();
+        } else {
+            gatherPaddedBlocks(chunk);
+            m_mesher.build(m_paddedBlocks.data(), m_paddedLight.data(), m_materials, m_meshData,
+                           m_separatePasses ? &translucentData : nullptr,
+                           m_separatePasses ? &m_cutoutMeshData : nullptr);
+        }
+
+        chunk.getMesh().upload(m_meshData);
+        chunk.getCutoutMesh().upload(m_cutoutMeshData);
+        m_lastRebuildStats.uploadedBytes += m_meshData.getByteCount() + m_cutoutMeshData.getByteCount();
         
-        // Create a voxel object for this block
-        std::shared_ptr<Voxel> voxel = Voxel::create(
-            textures->top,
-            textures->bottom,
-            textures->front,
-            textures->back,
-            textures->left,
-            textures->right
-        );
+        // Uploaded in mesh order, sorted when first drawn
+        chunk.getTranslucentMesh().upload(translucentData);
+        chunk.invalidateTranslucentSort();
+        m_lastRebuildStats.uploadedBytes += translucentData.getByteCount();
+        chunk.setFaceConnectivity(m_visibilityGraph.computeConnectivity(chunk, m_materials));
         
-        if (!voxel) {
-            std::cerr << "Error: Failed to create voxel for block type: " << blockType << std::endl;
+        // Coarse levels are remeshed when they are next drawn
+        for (int lod = 1; lod < CHUNK_LOD_COUNT; lod++) {
+            chunk.setLodStale(lod, true);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    m_lastRebuildStats.chunksRebuilt = m_dirtyChunks.size();
+    m_lastRebuildStats.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    m_dirtyChunks.clear();
+    return true;
+}
+
+void BaseModel::render(const glm::mat4& view, const glm::mat4& projection,
+                       const glm::vec3& lightDir, const glm::vec3& lightColor,
+                       const glm::vec3& viewPos) {
+    // Pick up any edits made since the last frame
+    rebuildDirtyChunks();
+
+    m_lastRenderStats = ChunkRenderStats();
+    m_translucentChunks.clear();
+    m_opaqueDraws.clear();
+    m_alphaTestedDraws.clear();
+
+    m_lastRenderStats.opaqueFeatures = getChunkFeatures(false);
+    if (ChunkMesh::getShaderProgram(m_mesher.getLayout(), m_lastRenderStats.opaqueFeatures) == 0 || !m_blockRegistry) {
+        return;
+    }
+
+    Frustum frustum(projection * view);
+    ChunkDrawBatcher& batcher = ChunkDrawBatcher::shared();
+
+    if (m_occlusionCulling) {
+        m_occlusionCuller.resize(m_chunks.size());
+    }
+    if (m_visibilityCulling) {
+        m_visibilityGraph.findVisible(m_chunks, glm::ivec3(m_chunksX, m_chunksY, m_chunksZ),
+                                      m_position, viewPos, frustum, m_reachableChunks);
+    }
+
+    for (size_t index = 0; index < m_chunks.size(); index++) {
+        Chunk* chunk = m_chunks[index].get();
+        if (chunk->getMesh().isEmpty() && chunk->getCutoutMesh().isEmpty() && chunk->getTranslucentMesh().isEmpty()) {
+            continue;
+        }
+
+        glm::vec3 origin(chunk->getOrigin());
+        glm::vec3 chunkMin, chunkMax;
+        getChunkBounds(*chunk, chunkMin, chunkMax);
+        if (!frustum.intersectsAABB(chunkMin, chunkMax)) {
+            m_lastRenderStats.chunksCulled++;
+            continue;
+        }
+        if (m_visibilityCulling && !m_reachableChunks[index]) {
+            m_lastRenderStats.chunksUnreachable++;
+            continue;
+        }
+
+        // Hidden chunks are still tested every frame so they reappear when uncovered
+        if (m_occlusionCulling) {
+            bool occluded = m_occlusionCuller.isOccluded(index, chunkMin, chunkMax, viewPos);
+            m_occlusionCuller.queueQuery(index, chunkMin, chunkMax);
+            if (occluded) {
+                m_lastRenderStats.chunksOccluded++;
+                continue;
+            }
+        }
+
+        glm::vec3 center = chunkMin + glm::vec3(CHUNK_SIZE * 0.5f);
+        glm::vec3 offset = center - viewPos;
+        float distance = glm::dot(offset, offset);
+
+        int lod = 0;
+        if (m_lodSettings.enabled) {
+            lod = selectLodLevel(m_lodSettings, chunk->getLodLevel(), std::sqrt(distance));
+        }
+        chunk->setLodLevel(lod);
+
+        // Coarse levels draw their leaves and translucent blocks with the rest, so
+        // they are alpha tested when they have any
+        const ChunkMesh& mesh = getLodMesh(*chunk, lod);
+        const ChunkMesh* cutout = (lod == 0 && !chunk->getCutoutMesh().isEmpty()) ? &chunk->getCutoutMesh() : nullptr;
+        const ChunkMesh* translucent = (lod == 0 && !chunk->getTranslucentMesh().isEmpty())
+                                     ? &chunk->getTranslucentMesh() : nullptr;
+        if (mesh.isEmpty() && !cutout && !translucent) {
+            continue;
+        }
+
+        size_t chunkTriangles = mesh.getTriangleCount() + (cutout ? cutout->getTriangleCount() : 0)
+                              + (translucent ? translucent->getTriangleCount() : 0);
+        if (!mesh.isEmpty() && !mesh.isAlphaTested()) {
+            m_opaqueDraws.push_back({ &mesh, origin, distance, lod, chunkTriangles });
+        } else if (!mesh.isEmpty()) {
+            m_alphaTestedDraws.push_back({ &mesh, origin, distance, lod, chunkTriangles });
+        }
+        if (cutout) {
+            m_alphaTestedDraws.push_back({ cutout, origin, distance, lod, chunkTriangles });
+            m_lastRenderStats.triangles += cutout->getTriangleCount();
+            m_lastRenderStats.meshBytes += cutout->getMemoryBytes();
+        }
+        if (translucent) {
+            m_translucentChunks.push_back(index);
+            m_lastRenderStats.triangles += translucent->getTriangleCount();
+            m_lastRenderStats.meshBytes += translucent->getMemoryBytes();
+        }
+
+        m_lastRenderStats.chunksDrawn++;
+        m_lastRenderStats.chunksPerLod[lod]++;
+        m_lastRenderStats.triangles += mesh.getTriangleCount();
+        m_lastRenderStats.meshBytes += mesh.getMemoryBytes();
+    }
+
+    // Nearest first, so the chunks in front fill the depth buffer before the
+    // fragments they hide are shaded
+    auto nearestFirst = [](const ChunkDraw& a, const ChunkDraw& b) { return a.distance < b.distance; };
+    std::sort(m_opaqueDraws.begin(), m_opaqueDraws.end(), nearestFirst);
+    std::sort(m_alphaTestedDraws.begin(), m_alphaTestedDraws.end(), nearestFirst);
+
+    // The pre-pass only takes the opaque meshes: a discarding depth program would
+    // lose early depth testing itself, and holes mustn't block what is behind them
+    bool prePassDone = false;
+    unsigned int depthProgram = ChunkMesh::getDepthShaderProgram(m_mesher.getLayout(), false);
+    if (m_depthPrePass && !m_opaqueDraws.empty() && depthProgram != 0) {
+        glUseProgram(depthProgram);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), m_position);
+        glUniformMatrix4fv(glGetUniformLocation(depthProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(depthProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniformMatrix4fv(glGetUniformLocation(depthProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
+
+        for (const ChunkDraw& draw : m_opaqueDraws) {
+            batcher.add(*draw.mesh, draw.origin);
+        }
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        m_lastRenderStats.prePassDrawCalls = batcher.submit(m_mesher.getLayout());
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        m_lastRenderStats.drawCalls += m_lastRenderStats.prePassDrawCalls;
+        prePassDone = true;
+    }
+
+    if (m_debugView != ChunkDebugView::NONE) {
+        m_lastRenderStats.drawCalls += renderDebugView(view, projection, prePassDone);
+        if (m_occlusionCulling) {
+            m_lastRenderStats.occlusionQueries = m_occlusionCuller.submitQueries(projection * view);
+        }
+        return;
+    }
+
+    // The occlusion boxes are queries too, so the meter has to stop before them
+    m_overdrawMeter.begin();
+
+    if (!m_opaqueDraws.empty()) {
+        useChunkProgram(view, projection, lightDir, lightColor, viewPos, false);
+        for (const ChunkDraw& draw : m_opaqueDraws) {
+            batcher.add(*draw.mesh, draw.origin);
+        }
+
+        // After the pre-pass only the nearest surface matches the stored depth
+        if (prePassDone) {
+            glDepthFunc(GL_LEQUAL);
+            glDepthMask(GL_FALSE);
+        }
+        m_lastRenderStats.drawCalls += batcher.submit(m_mesher.getLayout());
+        if (prePassDone) {
+            glDepthMask(GL_TRUE);
+            glDepthFunc(GL_LESS);
+        }
+    }
+
+    // Holes need the discarding program, which loses early depth testing, so it
+    // only draws what needs it and after the opaque pass filled the depth buffer
+    if (!m_alphaTestedDraws.empty() && useChunkProgram(view, projection, lightDir, lightColor, viewPos, true) != 0) {
+        for (const ChunkDraw& draw : m_alphaTestedDraws) {
+            batcher.add(*draw.mesh, draw.origin);
+        }
+        m_lastRenderStats.alphaTestedChunks = m_alphaTestedDraws.size();
+        m_lastRenderStats.drawCalls += batcher.submit(m_mesher.getLayout());
+    }
+
+    m_overdrawMeter.end();
+    m_lastRenderStats.overdraw = m_overdrawMeter.getOverdraw();
+
+    // Boxes go after the chunks so they are tested against this frame's depth
+    if (m_occlusionCulling) {
+        m_lastRenderStats.occlusionQueries = m_occlusionCuller.submitQueries(projection * view);
+    }
+}
+
+void BaseModel::renderTranslucent(const glm::mat4& view, const glm::mat4& projection,
+                                  const glm::vec3& lightDir, const glm::vec3& lightColor,
+                                  const glm::vec3& viewPos) {
+    // Alpha tested as well: the faces write depth, the clear texels of glass mustn't.
+    // Debug views draw the translucent faces with everything else.
+    if (m_translucentChunks.empty() || m_debugView != ChunkDebugView::NONE || useChunkProgram(view, projection, lightDir, lightColor, viewPos, true) == 0) {
+        return;
+    }
+
+    // Block units with the model's minimum corner at 0, the space meshes are built in
+    glm::vec3 eye = viewPos - m_position + glm::vec3(0.5f);
+    glm::ivec3 eyeCell(glm::floor(eye));
+
+    // Farthest chunk first. Chunks don't overlap, so ordering their centres is
+    // enough except for faces right on a shared boundary.
+    std::vector<std::pair<float, size_t>> order;
+    order.reserve(m_translucentChunks.size());
+    for (size_t index : m_translucentChunks) {
+        glm::vec3 center = glm::vec3(m_chunks[index]->getOrigin()) + glm::vec3(CHUNK_SIZE * 0.5f);
+        glm::vec3 offset = center - eye;
+        order.emplace_back(glm::dot(offset, offset), index);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) {
+        return a.first > b.first;
+    });
+
+    ChunkDrawBatcher& batcher = ChunkDrawBatcher::shared();
+    for (const auto& entry : order) {
+        Chunk& chunk = *m_chunks[entry.second];
+
+        // Sorting from the centre of the camera's block gives one order per block,
+        // so a camera moving inside it never triggers a re-sort
+        glm::ivec3 cell = eyeCell - chunk.getOrigin();
+        if (!chunk.isTranslucentSortedFor(cell)) {
+            ChunkMeshData& data = chunk.getTranslucentData();
+            m_mesher.sortBackToFront(data, glm::vec3(cell) + glm::vec3(0.5f));
+            chunk.getTranslucentMesh().upload(data);
+            chunk.setTranslucentSortCell(cell);
+            m_lastRenderStats.translucentSorts++;
+        }
+        batcher.add(chunk.getTranslucentMesh(), glm::vec3(chunk.getOrigin()));
+    }
+    m_lastRenderStats.translucentChunks = order.size();
+
+    // Depth writes stay on: with the faces in order they don't hide anything behind
+    // them, and the sky drawn afterwards stays behind glass
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_lastRenderStats.drawCalls += batcher.submit(m_mesher.getLayout(), true);
+    glDisable(GL_BLEND);
+}
+
+size_t BaseModel::renderDebugView(const glm::mat4& view, const glm::mat4& projection, bool prePassDone) {
+    // Detail levels 1x/2x/4x/8x, like the LOD labels of the world viewer
+    static const glm::vec3 kLodColors[CHUNK_LOD_COUNT] = {
+        glm::vec3(0.2f, 0.8f, 0.2f), glm::vec3(0.9f, 0.9f, 0.2f),
+        glm::vec3(0.9f, 0.5f, 0.1f), glm::vec3(0.9f, 0.2f, 0.2f)
+    };
+    
+    // Every pass of the normal path, the translucent faces last
+    std::vector<std::pair<const ChunkDraw*, bool>> draws;
+    std::vector<ChunkDraw> translucentDraws;
+    for (const ChunkDraw& draw : m_opaqueDraws) {
+        draws.emplace_back(&draw, false);
+    }
+    for (const ChunkDraw& draw : m_alphaTestedDraws) {
+        draws.emplace_back(&draw, true);
+    }
+    for (size_t index : m_translucentChunks) {
+        const Chunk& chunk = *m_chunks[index];
+        size_t chunkTriangles = chunk.getMesh().getTriangleCount() + chunk.getCutoutMesh().getTriangleCount()
+                              + chunk.getTranslucentMesh().getTriangleCount();
+        translucentDraws.push_back({ &chunk.getTranslucentMesh(), glm::vec3(chunk.getOrigin()), 0.0f, 0, chunkTriangles });
+    }
+    for (const ChunkDraw& draw : translucentDraws) {
+        draws.emplace_back(&draw, true);
+    }
+    
+    if (m_debugView == ChunkDebugView::OVERDRAW) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+    }
+    if (prePassDone) {
+        glDepthFunc(GL_LEQUAL);
+    }
+    
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), m_position);
+    glm::vec3 gridOrigin = m_position - glm::vec3(0.5f);
+    ChunkDrawBatcher& batcher = ChunkDrawBatcher::shared();
+    unsigned int boundProgram = 0;
+    GLint colorLocation = -1;
+    GLint quadSizeLocation = -1;
+    size_t drawCalls = 0;
+    
+    for (const auto& entry : draws) {
+        const ChunkDraw& draw = *entry.first;
+        unsigned int program = ChunkMesh::getDebugShaderProgram(m_mesher.getLayout(), m_debugView, entry.second);
+        if (program == 0) {
             continue;
         }
+        if (program != boundProgram) {
+            glUseProgram(program);
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniform3fv(glGetUniformLocation(program, "gridOrigin"), 1, glm::value_ptr(gridOrigin));
+            glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+            colorLocation = glGetUniformLocation(program, "debugColor");
+            quadSizeLocation = glGetUniformLocation(program, "quadSize");
+            boundProgram = program;
+            
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, BlockTextureArray::shared().getTexture());
+        }
         
-        // Position the voxel at its grid position plus the model's offset
-        // Note: Each voxel is 1x1x1 unit, so we can use grid coordinates directly
-        voxel->setPosition(glm::vec3(
-            m_position.x + static_cast<float>(pos.x),
-            m_position.y + static_cast<float>(pos.y),
-            m_position.z + static_cast<float>(pos.z)
-        ));
+        glm::vec3 color(1.0f);
+        if (m_debugView == ChunkDebugView::LOD_LEVELS) {
+            color = kLodColors[draw.lod];
+        } else if (m_debugView == ChunkDebugView::VERTEX_COUNT) {
+            // Four vertices per face in either layout, on a log scale up to a
+            // chunk of nothing but separate blocks
+            size_t vertices = draw.chunkTriangles * 2;
+            float t = std::log2(1.0f + vertices) / std::log2(1.0f + CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE * 12.0f);
+            t = std::clamp(t, 0.0f, 1.0f);
+            color = glm::clamp(glm::vec3(4.0f * t - 2.0f, 2.0f - std::abs(4.0f * t - 2.0f), 2.0f - 4.0f * t),
+                               glm::vec3(0.0f), glm::vec3(1.0f));
+        } else if (m_debugView == ChunkDebugView::CHUNK_BOUNDS) {
+            // Neighbouring chunks get clearly different tints
+            glm::ivec3 cell = glm::ivec3(draw.origin) / CHUNK_SIZE;
+            uint32_t hash = static_cast<uint32_t>(cell.x * 73856093) ^ static_cast<uint32_t>(cell.y * 19349663)
+                          ^ static_cast<uint32_t>(cell.z * 83492791);
+            color = glm::vec3((hash & 0xFF) / 255.0f, ((hash >> 8) & 0xFF) / 255.0f, ((hash >> 16) & 0xFF) / 255.0f)
+                  * 0.6f + glm::vec3(0.2f);
+        }
+        glUniform3fv(colorLocation, 1, glm::value_ptr(color));
+        glUniform1f(quadSizeLocation, static_cast<float>(1 << draw.lod));
         
-        // Store the voxel object
-        m_voxels[pos] = voxel;
+        batcher.add(*draw.mesh, draw.origin);
+        drawCalls += batcher.submit(m_mesher.getLayout());
     }
     
-    return true;
+    if (prePassDone) {
+        glDepthFunc(GL_LESS);
+    }
+    glDisable(GL_BLEND);
+    return drawCalls;
 }
 
-void BaseModel::render(const glm::mat4& view, const glm::mat4& projection, 
-                       const glm::vec3& lightDir, const glm::vec3& lightColor, 
-                       const glm::vec3& viewPos) {
-    // Identity model matrix (position is already set for each voxel)
-    glm::mat4 model = glm::mat4(1.0f);
-    
-    // Render each voxel
-    for (const auto& [pos, voxel] : m_voxels) {
-        voxel->render(model, view, projection, lightDir, lightColor, viewPos);
+const char* BaseModel::getDebugViewName(ChunkDebugView view) {
+    switch (view) {
+        case ChunkDebugView::NONE: return "None";
+        case ChunkDebugView::OVERDRAW: return "Overdraw";
+        case ChunkDebugView::TRIANGLE_DENSITY: return "Triangle Density";
+        case ChunkDebugView::CHUNK_BOUNDS: return "Chunk Bounds";
+        case ChunkDebugView::LOD_LEVELS: return "LOD Levels";
+        case ChunkDebugView::VERTEX_COUNT: return "Vertex Count";
+    }
+    return "";
+}
+
+unsigned int BaseModel::useChunkProgram(const glm::mat4& view, const glm::mat4& projection,
+                                        const glm::vec3& lightDir, const glm::vec3& lightColor,
+                                        const glm::vec3& viewPos, bool alphaTest) {
+    unsigned int program = ChunkMesh::getShaderProgram(m_mesher.getLayout(), getChunkFeatures(alphaTest));
+    if (program == 0 || !m_blockRegistry) {
+        return 0;
+    }
+
+    glUseProgram(program);
+
+    // Uniforms shared by every chunk
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform3fv(glGetUniformLocation(program, "lightDir"), 1, glm::value_ptr(lightDir));
+    glUniform3fv(glGetUniformLocation(program, "lightColor"), 1, glm::value_ptr(lightColor));
+    glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, glm::value_ptr(viewPos));
+    glUniform1f(glGetUniformLocation(program, "ambientStrength"), m_ambientStrength);
+    glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+
+    // Every face texture lives in one array, so chunks need no per-block binds
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, BlockTextureArray::shared().getTexture());
+    Lightmap::shared().bind(program, 1);
+    if (m_shadowMap) {
+        m_shadowMap->bind(program, 2);
+    }
+    if (m_fog.enabled) {
+        glUniform3fv(glGetUniformLocation(program, "fogColor"), 1, glm::value_ptr(m_fog.color));
+        glUniform1f(glGetUniformLocation(program, "fogStart"), m_fog.start);
+        glUniform1f(glGetUniformLocation(program, "fogEnd"), m_fog.end);
+    }
+
+    // Chunks are offset by their per-draw origin, the matrix only places the model
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), m_position);
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(model));
+    return program;
+}
+
+unsigned int BaseModel::getChunkFeatures(bool alphaTest) const {
+    unsigned int features = m_shaderFeatures & (ShaderUtils::AO | ShaderUtils::SPECULAR);
+    if (m_shadowMap) {
+        features |= ShaderUtils::SHADOWS;
+    }
+    if (m_fog.enabled) {
+        features |= ShaderUtils::FOG;
+    }
+    if (alphaTest) {
+        features |= ShaderUtils::ALPHA_TEST;
+    }
+    return features;
+}
+
+size_t BaseModel::renderDepth(const glm::mat4& lightSpaceMatrix, const glm::vec3& viewPos) {
+    rebuildDirtyChunks();
+
+    unsigned int program = ChunkMesh::getDepthShaderProgram(m_mesher.getLayout());
+    if (program == 0 || !m_blockRegistry) {
+        return 0;
+    }
+
+    glUseProgram(program);
+
+    // The light's matrix takes world space straight to its clip space
+    glm::mat4 identity(1.0f);
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(identity));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+    glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+
+    // Leaves and glass need their texture to cut out the holes
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, BlockTextureArray::shared().getTexture());
+
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), m_position);
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(model));
+
+    // Chunks hidden from the camera can still cast shadows into view, so only the
+    // light's frustum culls here
+    Frustum frustum(lightSpaceMatrix);
+    ChunkDrawBatcher& batcher = ChunkDrawBatcher::shared();
+
+    for (const auto& chunk : m_chunks) {
+        if (chunk->getMesh().isEmpty() && chunk->getCutoutMesh().isEmpty() && chunk->getTranslucentMesh().isEmpty()) {
+            continue;
+        }
+
+        glm::vec3 chunkMin, chunkMax;
+        getChunkBounds(*chunk, chunkMin, chunkMax);
+        if (!frustum.intersectsAABB(chunkMin, chunkMax)) {
+            continue;
+        }
+
+        int lod = 0;
+        if (m_lodSettings.enabled) {
+            glm::vec3 center = chunkMin + glm::vec3(CHUNK_SIZE * 0.5f);
+            lod = selectLodLevel(m_lodSettings, chunk->getLodLevel(), glm::length(center - viewPos));
+        }
+
+        const ChunkMesh& mesh = getLodMesh(*chunk, lod);
+        if (!mesh.isEmpty()) {
+            batcher.add(mesh, glm::vec3(chunk->getOrigin()));
+        }
+
+        // Leaves and glass cast shadows too, depth needs no order
+        if (lod == 0 && !chunk->getCutoutMesh().isEmpty()) {
+            batcher.add(chunk->getCutoutMesh(), glm::vec3(chunk->getOrigin()));
+        }
+        if (lod == 0 && !chunk->getTranslucentMesh().isEmpty()) {
+            batcher.add(chunk->getTranslucentMesh(), glm::vec3(chunk->getOrigin()));
+        }
+    }
+
+    return batcher.submit(m_mesher.getLayout());
+}
+
+void BaseModel::getBounds(glm::vec3& min, glm::vec3& max) const {
+    min = m_position - glm::vec3(0.5f);
+    max = min + glm::vec3(static_cast<float>(m_width), static_cast<float>(m_height), static_cast<float>(m_depth));
+}
+
+int BaseModel::selectLodLevel(const LodSettings& settings, int current, float distance) {
+    if (!settings.enabled) {
+        return 0;
     }
+
+    int lod = std::clamp(current, 0, CHUNK_LOD_COUNT - 1);
+    while (lod < CHUNK_LOD_COUNT - 1 && distance > settings.distances[lod] + settings.hysteresis) {
+        lod++;
+    }
+    while (lod > 0 && distance < settings.distances[lod - 1] - settings.hysteresis) {
+        lod--;
+    }
+    return lod;
+}
+
+const ChunkMesh& BaseModel::getLodMesh(Chunk& chunk, int lod) {
+    if (lod > 0 && chunk.isLodStale(lod)) {
+        gatherLodBlocks(chunk, lod);
+        m_mesher.build(m_paddedBlocks.data(), m_paddedLight.data(), CHUNK_SIZE >> lod, 1 << lod,
+                       m_materials, m_meshData);
+        chunk.getMesh(lod).upload(m_meshData);
+        chunk.setLodStale(lod, false);
+        m_lastRenderStats.lodMeshesBuilt++;
+    }
+    return chunk.getMesh(lod);
 }
 
 void BaseModel::clear() {
-    m_blocks.clear();
-    m_voxels.clear();
+    for (size_t i = 0; i < m_chunks.size(); i++) {
+        if (!m_chunks[i]->isEmpty()) {
+            m_chunks[i]->clear();
+            markChunkDirty(i);
+        }
+    }
+    m_voxelCount = 0;
+    m_lightingStale = true;
 }
 
 size_t BaseModel::getVoxelCount() const {
-    return m_blocks.size();
+    return m_voxelCount;
 }
 
 std::vector<VoxelPosition> BaseModel::getOccupiedPositions() const {
     std::vector<VoxelPosition> positions;
-    positions.reserve(m_blocks.size());
-    
-    for (const auto& [pos, blockType] : m_blocks) {
-        positions.push_back(pos);
+    positions.reserve(m_voxelCount);
+
+    for (const auto& chunk : m_chunks) {
+        if (chunk->isEmpty()) {
+            continue;
+        }
+
+        glm::ivec3 origin = chunk->getOrigin();
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                for (int x = 0; x < CHUNK_SIZE; x++) {
+                    if (chunk->getBlock(x, y, z) != 0) {
+                        positions.emplace_back(origin.x + x, origin.y + y, origin.z + z);
+                    }
+                }
+            }
+        }
     }
-    
+
     return positions;
 }
 
-} // namespace Zenith
\ No newline at end of file
+} // namespace Zenith
@@ -1,13 +1,22 @@
 #ifndef BASE_MODEL_H
 #define BASE_MODEL_H
 
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include "Blocks/BlockRegistryReader.h"
-#include "Blocks/Voxel.h"
+#include "Blocks/BlockMaterial.h"
+#include "World/Chunks/Chunk.h"
+#include "World/Chunks/ChunkMesher.h"
+#include "World/Chunks/ChunkLightEngine.h"
+#include "World/Chunks/ChunkOcclusionCuller.h"
+#include "World/Chunks/ChunkOverdrawMeter.h"
+#include "World/Chunks/ChunkVisibilityGraph.h"
+#include "World/Lighting/ShadowMap.h"
 
 namespace Zenith {
 
@@ -35,6 +44,50 @@ struct VoxelPosition {
     }
 };
 
+// Timing of the last chunk rebuild, for the viewers' stats
+struct ChunkRebuildStats {
+    size_t chunksRebuilt = 0;
+    size_t uploadedBytes = 0;
+    double milliseconds = 0.0;
+};
+
+// When chunks switch to their coarser meshes. Distances are in blocks from the
+// camera to the chunk centre.
+struct LodSettings {
+    bool enabled = false;
+    std::array<float, CHUNK_LOD_COUNT - 1> distances = { 64.0f, 128.0f, 256.0f };
+    float hysteresis = 8.0f;    // Margin before switching back, stops chunks flickering on a boundary
+};
+
+// Distance fog of the chunk shader's FOG permutation. Distances are in blocks
+// from the camera.
+struct FogSettings {
+    bool enabled = false;
+    glm::vec3 color = glm::vec3(0.6f, 0.7f, 0.9f);
+    float start = 96.0f;
+    float end = 192.0f;
+};
+
+// Counters of the last render() call
+struct ChunkRenderStats {
+    size_t chunksDrawn = 0;
+    std::array<size_t, CHUNK_LOD_COUNT> chunksPerLod{};
+    size_t triangles = 0;
+    size_t lodMeshesBuilt = 0;
+    size_t meshBytes = 0;       // GPU memory of the drawn meshes (the shared index buffer is not counted)
+    size_t chunksCulled = 0;    // Outside the view frustum
+    size_t chunksUnreachable = 0;   // No open path from the camera's chunk (see ChunkVisibilityGraph)
+    size_t chunksOccluded = 0;  // Inside the frustum but hidden last time they were tested
+    size_t occlusionQueries = 0;    // Box draws issued, on top of drawCalls
+    size_t drawCalls = 0;
+    size_t prePassDrawCalls = 0;    // Depth pre-pass draws, included in drawCalls
+    size_t alphaTestedChunks = 0;   // Drawn again with the discarding program: fancy leaves, coarse levels with holes
+    size_t translucentChunks = 0;   // Chunks drawn by renderTranslucent(), included in chunksDrawn
+    size_t translucentSorts = 0;    // Of those, re-sorted because the camera changed block
+    double overdraw = 0.0;      // Fragments shaded per viewport pixel by the opaque passes, a few frames old (see ChunkOverdrawMeter)
+    unsigned int opaqueFeatures = 0;    // Shader permutation of the opaque pass, a ShaderUtils::Feature mask
+};
+
 class BaseModel {
 public:
     // Constructor: Initialize a model with dimensions p x q x r
@@ -62,14 +115,109 @@ public:
     // Get the dimensions of the model
     void getDimensions(int& p, int& q, int& r) const;
     
-    // Create voxel objects for rendering
+    // Bind the block registry used for rendering and mesh every chunk
     bool createVoxelObjects(const BlockRegistryReader& blockRegistry);
     
-    // Render the model
+    // Remesh only the chunks touched since the last rebuild. Called by render(),
+    // so edits show up on the next frame without a full createVoxelObjects().
+    // Returns true if any chunk was rebuilt.
+    bool rebuildDirtyChunks();
+    
+    // Stats of the last rebuild that actually remeshed something
+    const ChunkRebuildStats& getLastRebuildStats() const { return m_lastRebuildStats; }
+    
+    // Stats of the last relight, full or incremental (see ChunkLightEngine)
+    const ChunkLightStats& getLastLightStats() const { return m_lightEngine.getLastStats(); }
+    
+    // Render the model, rebuilding dirty chunks first. Chunks outside the view are
+    // skipped and the rest batched into a few multi-draw calls, nearest first so
+    // early depth testing rejects what they hide. With LOD enabled, chunks far from
+    // viewPos are drawn with downsampled meshes.
     void render(const glm::mat4& view, const glm::mat4& projection, 
                 const glm::vec3& lightDir, const glm::vec3& lightColor, 
                 const glm::vec3& viewPos);
     
+    // Blend the translucent faces of the chunks the last render() found visible,
+    // farthest chunk first, each sorted back to front. A chunk's faces are only
+    // re-sorted when the camera moves into another block. Call last, after every
+    // opaque pass (other models, prefabs) and the sky: the faces write depth, so
+    // a sky drawn after them would be rejected behind the glass.
+    void renderTranslucent(const glm::mat4& view, const glm::mat4& projection,
+                           const glm::vec3& lightDir, const glm::vec3& lightColor,
+                           const glm::vec3& viewPos);
+    
+    // Shadow map sampled by render(), nullptr for the chunk program without shadow
+    // code. Must stay alive while set.
+    void setShadowMap(const ShadowMap* shadowMap) { m_shadowMap = shadowMap; }
+    
+    // Share of the light colour every face gets regardless of the light direction
+    void setAmbientStrength(float strength) { m_ambientStrength = strength; }
+    
+    // Optional shading features the chunk program is built with, a mask of
+    // ShaderUtils::AO and ShaderUtils::SPECULAR (both by default); leaving them
+    // out gives a cheaper program for low quality settings. The other features
+    // follow the state: SHADOWS with a shadow map, FOG with fog enabled and
+    // ALPHA_TEST for the passes that cut out holes.
+    void setShaderFeatures(unsigned int features) { m_shaderFeatures = features; }
+    unsigned int getShaderFeatures() const { return m_shaderFeatures; }
+    
+    // Distance fog over the chunks, off by default
+    void setFog(const FogSettings& fog) { m_fog = fog; }
+    const FogSettings& getFog() const { return m_fog; }
+    
+    // Draw the chunks inside the light's frustum into the bound shadow map, at the
+    // detail levels the camera at viewPos sees them. Returns the number of draw calls.
+    size_t renderDepth(const glm::mat4& lightSpaceMatrix, const glm::vec3& viewPos);
+    
+    // World space box around the whole model
+    void getBounds(glm::vec3& min, glm::vec3& max) const;
+    
+    // Switch between classic vertex buffers and vertex pulling from face records.
+    // Every chunk is remeshed on the next rebuild. Returns false (keeping the
+    // current layout) if the context can't do vertex pulling.
+    bool setMeshLayout(ChunkMeshLayout layout);
+    ChunkMeshLayout getMeshLayout() const { return m_mesher.getLayout(); }
+    
+    // Skip chunks hidden behind nearer geometry, using occlusion queries from
+    // earlier frames (see ChunkOcclusionCuller)
+    void setOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+    bool isOcclusionCullingEnabled() const { return m_occlusionCulling; }
+    
+    // Skip chunks the camera can't see through any chain of open chunk faces
+    // (caves and buried chunks), see ChunkVisibilityGraph
+    void setVisibilityCulling(bool enabled) { m_visibilityCulling = enabled; }
+    bool isVisibilityCullingEnabled() const { return m_visibilityCulling; }
+    
+    // Lay down the depth of the opaque chunks with a depth-only program before
+    // shading them, so each pixel is shaded once whatever the draw order. Costs a
+    // second pass over the vertices; pays off when fragments are the bottleneck.
+    void setDepthPrePass(bool enabled) { m_depthPrePass = enabled; }
+    bool isDepthPrePassEnabled() const { return m_depthPrePass; }
+    
+    // Replace the shading of render() with a debug colouring of the chunks,
+    // NONE to draw normally. Translucent faces are drawn in the same pass and
+    // renderTranslucent() draws nothing. A view's program is only built once it
+    // is picked, so normal drawing pays nothing for them.
+    void setDebugView(ChunkDebugView view) { m_debugView = view; }
+    ChunkDebugView getDebugView() const { return m_debugView; }
+    
+    // Label for UI lists, in ChunkDebugView order
+    static const char* getDebugViewName(ChunkDebugView view);
+    
+    // Fast or fancy leaves. Changing it remeshes every chunk on the next rebuild.
+    void setLeavesMode(LeavesMode mode);
+    LeavesMode getLeavesMode() const { return m_leavesMode; }
+    
+    // Level of detail used by render()
+    void setLodSettings(const LodSettings& settings) { m_lodSettings = settings; }
+    const LodSettings& getLodSettings() const { return m_lodSettings; }
+    
+    // Detail level for an object at `distance`, currently drawn at level `current`
+    static int selectLodLevel(const LodSettings& settings, int current, float distance);
+    
+    // Counters of the last render() call
+    const ChunkRenderStats& getLastRenderStats() const { return m_lastRenderStats; }
+    
     // Clear all voxels
     void clear();
     
@@ -79,6 +227,16 @@ public:
     // Get all occupied positions
     std::vector<VoxelPosition> getOccupiedPositions() const;
     
+    // Get the palette index at a position (0 if empty or out of bounds)
+    uint16_t getBlockId(int x, int y, int z) const;
+    
+    // Get the packed sky and block light at a position, full sky light outside the chunk grid
+    uint8_t getLight(int x, int y, int z) const;
+    
+    // Number of chunks along each axis and access to them
+    void getChunkGridSize(int& x, int& y, int& z) const;
+    const Chunk& getChunk(int cx, int cy, int cz) const;
+    
 protected:
     // Dimensions of the model
     int m_width;  // p
@@ -88,11 +246,133 @@ protected:
     // Position of the model in 3D space
     glm::vec3 m_position;
     
-    // Map from position to block type
-    std::unordered_map<VoxelPosition, std::string, VoxelPosition::Hash> m_blocks;
+    // Block type names, blocks are stored as indices into this list (0 = empty)
+    std::vector<std::string> m_palette;
+    std::unordered_map<std::string, uint16_t> m_paletteLookup;
     
-    // Map from position to voxel object for rendering
-    std::unordered_map<VoxelPosition, std::shared_ptr<Voxel>, VoxelPosition::Hash> m_voxels;
+    // Chunks covering the model volume, x fastest then z then y
+    int m_chunksX, m_chunksY, m_chunksZ;
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    
+    // Chunks waiting to be remeshed
+    std::vector<size_t> m_dirtyChunks;
+    
+    // Number of non-empty cells
+    size_t m_voxelCount;
+    
+    // Registry bound by createVoxelObjects() and the materials resolved from it
+    const BlockRegistryReader* m_blockRegistry;
+    std::vector<BlockMaterial> m_materials;
+    
+    // Scratch state reused by every rebuild
+    ChunkMesher m_mesher;
+    ChunkMeshData m_meshData;
+    std::vector<uint16_t> m_paddedBlocks;
+    std::vector<uint8_t> m_paddedLight;
+    ChunkRebuildStats m_lastRebuildStats;
+    
+    // Sky and block light. Until the first rebuild after createVoxelObjects() or
+    // clear() edits aren't tracked, the whole model is relit instead.
+    ChunkLightEngine m_lightEngine;
+    bool m_lightingStale;
+    std::vector<size_t> m_relitChunks;
+    
+    LodSettings m_lodSettings;
+    ChunkRenderStats m_lastRenderStats;
+    
+    bool m_occlusionCulling;
+    ChunkOcclusionCuller m_occlusionCuller;
+    
+    bool m_visibilityCulling;
+    ChunkVisibilityGraph m_visibilityGraph;
+    std::vector<uint8_t> m_reachableChunks;
+    
+    const ShadowMap* m_shadowMap;
+    float m_ambientStrength;
+    unsigned int m_shaderFeatures;
+    FogSettings m_fog;
+    
+    // Whether full resolution meshes split the cutout and translucent faces off
+    // into their own passes. Models drawn another way keep them in the one mesh,
+    // alpha tested.
+    bool m_separatePasses;
+    LeavesMode m_leavesMode;
+    ChunkMeshData m_cutoutMeshData;
+    std::vector<size_t> m_translucentChunks;    // Visible at full detail in the last render()
+    
+    bool m_depthPrePass;
+    ChunkOverdrawMeter m_overdrawMeter;
+    
+    ChunkDebugView m_debugView;
+    
+    // A mesh queued by render(), with its squared distance to the camera
+    struct ChunkDraw {
+        const ChunkMesh* mesh;
+        glm::vec3 origin;
+        float distance;
+        int lod;
+        size_t chunkTriangles;  // Of every mesh the chunk draws, for the vertex count view
+    };
+    
+    // Meshes of the last render(), sorted nearest first: the opaque pass, then
+    // the ones drawn after it with the alpha tested program
+    std::vector<ChunkDraw> m_opaqueDraws;
+    std::vector<ChunkDraw> m_alphaTestedDraws;
+    
+    // Mesh of a chunk at a detail level, building it first if it is stale
+    const ChunkMesh& getLodMesh(Chunk& chunk, int lod);
+    
+    // Bind the chunk program for the current layout with the textures and the
+    // uniforms shared by every chunk, 0 if it isn't available
+    unsigned int useChunkProgram(const glm::mat4& view, const glm::mat4& projection,
+                                 const glm::vec3& lightDir, const glm::vec3& lightColor,
+                                 const glm::vec3& viewPos, bool alphaTest);
+    
+    // Permutation of the chunk program for a pass, see setShaderFeatures()
+    unsigned int getChunkFeatures(bool alphaTest) const;
+    
+    // Draw the queued meshes of render() and the translucent ones with the debug
+    // view's program, one call per mesh for the per-chunk colours. Returns the
+    // number of draw calls.
+    size_t renderDebugView(const glm::mat4& view, const glm::mat4& projection, bool prePassDone);
+    
+    // World space box of a chunk: blocks are centred on their coordinates, so it
+    // spans origin - 0.5 to origin + 15.5
+    void getChunkBounds(const Chunk& chunk, glm::vec3& min, glm::vec3& max) const {
+        min = m_position + glm::vec3(chunk.getOrigin()) - glm::vec3(0.5f);
+        max = min + glm::vec3(static_cast<float>(CHUNK_SIZE));
+    }
+    
+private:
+    // Get (or add) the palette index of a block type
+    uint16_t getPaletteId(const std::string& blockType);
+    
+    // Store a palette index and mark the affected chunks dirty
+    void setBlockId(int x, int y, int z, uint16_t blockId);
+    
+    // Mark the chunk holding a position dirty, plus neighbours whose mesh sees it
+    void markDirtyAround(int x, int y, int z);
+    void markChunkDirty(size_t chunkIndex);
+    
+    // Resolve materials for palette entries added since the last rebuild
+    void resolveMaterials();
+    
+    // Relight the whole model or just around the edits since the last rebuild,
+    // marking the chunks that see changed light dirty
+    void updateLighting();
+    
+    // Copy a chunk and its one block border into m_paddedBlocks, and their light
+    // into m_paddedLight
+    void gatherPaddedBlocks(const Chunk& chunk);
+    
+    // Downsample a chunk and a one cell border by 2^lod into m_paddedBlocks. Each
+    // coarse cell takes the most common block of its cells, or stays empty when
+    // fewer than half of them are filled. Its light is the brightest of its cells.
+    void gatherLodBlocks(const Chunk& chunk, int lod);
+    
+    size_t chunkIndex(int cx, int cy, int cz) const {
+        return (static_cast<size_t>(cy) * m_chunksZ + cz) * m_chunksX + cx;
+    }
 };
 
 } // namespace Zenith
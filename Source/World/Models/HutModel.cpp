@@ -20,6 +20,11 @@ void HutModel::setRandomSeed(unsigned int seed) {
     m_hasCustomSeed = true;
 }
 
+void HutModel::setRandomStream(uint64_t seed, uint64_t stream) {
+    m_rng.seed(seed, stream);
+    m_hasCustomSeed = true;
+}
+
 void HutModel::generateHut(HutType type, bool withFurnishings) {
     // Clear any existing model data
     clear();
@@ -549,8 +554,7 @@ std::string HutModel::getRoofMaterial() const {
 }
 
 int HutModel::randomInt(int min, int max) const {
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(m_rng);
+    return m_rng.uniformInt(min, max);
 }
 
 } // namespace Zenith
\ No newline at end of file
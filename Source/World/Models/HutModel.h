@@ -3,7 +3,8 @@
 #define HUT_MODEL_H
 
 #include "BaseModel.h"
-#include <random>
+#include "Utils/Random.h"
+#include <cstdint>
 
 namespace Zenith {
 
@@ -26,9 +27,13 @@ public:
     // Set random seed for hut generation
     void setRandomSeed(unsigned int seed);
     
+    // Use stream `stream` of `seed`, so batch generation can give every model its own
+    // reproducible sequence independent of generation order
+    void setRandomStream(uint64_t seed, uint64_t stream);
+    
 private:
     // Random number generator
-    mutable std::mt19937 m_rng;
+    mutable PhiloxRng m_rng;
     bool m_hasCustomSeed;
     
     // Helper methods for hut generation
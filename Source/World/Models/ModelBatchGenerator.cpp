@@ -0,0 +1,69 @@
+#include "ModelBatchGenerator.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
+#include <thread>
+
+namespace Zenith {
+
+namespace {
+
+// Indices handed to a worker at a time, small enough to balance uneven models
+const size_t kBatchGrain = 64;
+
+const int kTreeTypeCount = 6;
+const int kHutTypeCount = 4;
+
+} // namespace
+
+ModelBatchGenerator::ModelBatchGenerator(unsigned int threadCount)
+    : m_threadCount(threadCount)
+{
+    if (m_threadCount == 0) {
+        m_threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<std::unique_ptr<TreeModel>> ModelBatchGenerator::generateTrees(size_t count, uint64_t baseSeed,
+                                                                           const TreeBatchSettings& settings) const {
+    std::vector<std::unique_ptr<TreeModel>> trees(count);
+    
+    ThreadPool::shared().parallelFor(count, [&](size_t i) {
+        auto tree = std::make_unique<TreeModel>(settings.maxHeight, settings.maxWidth);
+        tree->setRandomStream(baseSeed, treeStream(i));
+        
+        // The type is drawn from the tree's own stream, before generation uses it
+        TreeType type = settings.type;
+        if (settings.randomType) {
+            PhiloxRng typeRng(baseSeed, treeStream(i) ^ (1ull << 62));
+            type = static_cast<TreeType>(typeRng.uniformInt(0, kTreeTypeCount - 1));
+        }
+        
+        tree->generateTree(type, settings.height);
+        trees[i] = std::move(tree);
+    }, kBatchGrain, m_threadCount);
+    
+    return trees;
+}
+
+std::vector<std::unique_ptr<HutModel>> ModelBatchGenerator::generateHuts(size_t count, uint64_t baseSeed,
+                                                                         const HutBatchSettings& settings) const {
+    std::vector<std::unique_ptr<HutModel>> huts(count);
+    
+    ThreadPool::shared().parallelFor(count, [&](size_t i) {
+        auto hut = std::make_unique<HutModel>(settings.maxWidth, settings.maxHeight, settings.maxDepth);
+        hut->setRandomStream(baseSeed, hutStream(i));
+        
+        HutType type = settings.type;
+        if (settings.randomType) {
+            PhiloxRng typeRng(baseSeed, hutStream(i) ^ (1ull << 62));
+            type = static_cast<HutType>(typeRng.uniformInt(0, kHutTypeCount - 1));
+        }
+        
+        hut->generateHut(type, settings.withFurnishings);
+        huts[i] = std::move(hut);
+    }, kBatchGrain, m_threadCount);
+    
+    return huts;
+}
+
+} // namespace Zenith
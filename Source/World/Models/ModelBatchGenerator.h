@@ -0,0 +1,60 @@
+#ifndef MODEL_BATCH_GENERATOR_H
+#define MODEL_BATCH_GENERATOR_H
+
+#include "TreeModel.h"
+#include "HutModel.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Zenith {
+
+// Settings shared by every tree of a batch
+struct TreeBatchSettings {
+    int maxHeight = 20;
+    int maxWidth = 15;
+    bool randomType = true;         // Pick the type per tree from its own stream
+    TreeType type = TreeType::OAK;  // Used when randomType is false
+    int height = 0;                 // 0 = random height for the tree type
+};
+
+// Settings shared by every hut of a batch
+struct HutBatchSettings {
+    int maxWidth = 20;
+    int maxHeight = 20;
+    int maxDepth = 20;
+    bool randomType = true;
+    HutType type = HutType::BASIC;
+    bool withFurnishings = true;
+};
+
+// Generates many trees/huts on worker threads. Model i always uses random stream i
+// of the base seed, so a batch is identical whatever the thread count.
+class ModelBatchGenerator {
+public:
+    // threadCount 0 uses std::thread::hardware_concurrency()
+    explicit ModelBatchGenerator(unsigned int threadCount = 0);
+    
+    // Generate `count` trees from `baseSeed`, result[i] is the model with index i
+    std::vector<std::unique_ptr<TreeModel>> generateTrees(size_t count, uint64_t baseSeed,
+                                                          const TreeBatchSettings& settings = TreeBatchSettings()) const;
+    
+    // Generate `count` huts from `baseSeed`, result[i] is the model with index i
+    std::vector<std::unique_ptr<HutModel>> generateHuts(size_t count, uint64_t baseSeed,
+                                                        const HutBatchSettings& settings = HutBatchSettings()) const;
+    
+    // Stream used for a model index; huts use a separate range so a tree and a hut
+    // with the same seed and index don't share random numbers
+    static uint64_t treeStream(size_t index) { return static_cast<uint64_t>(index); }
+    static uint64_t hutStream(size_t index) { return (1ull << 63) | static_cast<uint64_t>(index); }
+    
+    unsigned int getThreadCount() const { return m_threadCount; }
+    
+private:
+    // Most threads of the shared pool a batch uses
+    unsigned int m_threadCount;
+};
+
+} // namespace Zenith
+
+#endif // MODEL_BATCH_GENERATOR_H
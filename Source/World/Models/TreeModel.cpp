@@ -18,6 +18,11 @@ void TreeModel::setRandomSeed(unsigned int seed) {
     m_hasCustomSeed = true;
 }
 
+void TreeModel::setRandomStream(uint64_t seed, uint64_t stream) {
+    m_rng.seed(seed, stream);
+    m_hasCustomSeed = true;
+}
+
 void TreeModel::generateTree(TreeType type, int height) {
     // Clear any existing tree data
     clear();
@@ -413,8 +418,7 @@ std::string TreeModel::getLeavesType(TreeType type) const {
 }
 
 int TreeModel::randomInt(int min, int max) {
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(m_rng);
+    return m_rng.uniformInt(min, max);
 }
 
 } // namespace Zenith
\ No newline at end of file
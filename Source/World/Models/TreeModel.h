@@ -2,7 +2,8 @@
 #define TREE_MODEL_H
 
 #include "BaseModel.h"
-#include <random>
+#include "Utils/Random.h"
+#include <cstdint>
 
 namespace Zenith {
 
@@ -27,9 +28,13 @@ public:
     // Set random seed for tree generation
     void setRandomSeed(unsigned int seed);
     
+    // Use stream `stream` of `seed`, so batch generation can give every model its own
+    // reproducible sequence independent of generation order
+    void setRandomStream(uint64_t seed, uint64_t stream);
+    
 private:
     // Random number generator
-    std::mt19937 m_rng;
+    PhiloxRng m_rng;
     bool m_hasCustomSeed;
     
     // Helper methods for tree generation
@@ -0,0 +1,212 @@
+#include "Prefab.h"
+#include "Utils/ShaderCache.h"
+#include "Utils/ShaderUtils.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace Zenith {
+
+Prefab::Prefab(const StructureTemplate& structure)
+    : BaseModel(structure.maxOffset.x - structure.minOffset.x + 1,
+                structure.maxOffset.y - structure.minOffset.y + 1,
+                structure.maxOffset.z - structure.minOffset.z + 1),
+      m_anchor(-structure.minOffset)
+{
+    m_instanceVBOs.fill(0);
+    m_instanceCapacities.fill(0);
+
+    // Instances can't be sorted against each other, leaves and glass stay alpha
+    // tested in the one mesh
+    m_separatePasses = false;
+
+    for (const StructureVoxel& voxel : structure.voxels) {
+        glm::ivec3 pos = glm::ivec3(voxel.x, voxel.y, voxel.z) + m_anchor;
+        addVoxel(pos.x, pos.y, pos.z, structure.palette[voxel.block]);
+    }
+}
+
+glm::mat4 Prefab::getInstanceMatrix(const PrefabInstance& instance) const {
+    static const float kCos[4] = { 1.0f, 0.0f, -1.0f, 0.0f };
+    static const float kSin[4] = { 0.0f, 1.0f, 0.0f, -1.0f };
+
+    // Exact quarter turn about Y; glm::rotate would leave rounding noise
+    int turn = instance.rotation & 3;
+    glm::mat4 rotation(1.0f);
+    rotation[0][0] = kCos[turn];
+    rotation[0][2] = -kSin[turn];
+    rotation[2][0] = kSin[turn];
+    rotation[2][2] = kCos[turn];
+
+    glm::mat4 mirror = glm::scale(glm::mat4(1.0f), glm::vec3(instance.mirror ? -1.0f : 1.0f, 1.0f, 1.0f));
+
+    // Blocks are centred on integer coordinates, so turning about the anchor
+    // block keeps them on the grid, where StructureTemplate::transformOffset()
+    // puts them
+    return glm::translate(glm::mat4(1.0f), glm::vec3(instance.position)) * rotation * mirror *
+           glm::translate(glm::mat4(1.0f), -glm::vec3(m_anchor));
+}
+
+size_t Prefab::addInstance(const PrefabInstance& instance) {
+    glm::mat4 matrix = getInstanceMatrix(instance);
+
+    // World bounds of the transformed model box, blocks reach half a block past
+    // their centres
+    glm::vec3 size(m_width, m_height, m_depth);
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 local((corner & 1) ? size.x - 0.5f : -0.5f, (corner & 2) ? size.y - 0.5f : -0.5f,
+                        (corner & 4) ? size.z - 0.5f : -0.5f);
+        glm::vec3 world = glm::vec3(matrix * glm::vec4(local, 1.0f));
+        boundsMin = glm::min(boundsMin, world);
+        boundsMax = glm::max(boundsMax, world);
+    }
+
+    m_instanceMatrices.push_back(matrix);
+    m_instanceMin.push_back(boundsMin);
+    m_instanceMax.push_back(boundsMax);
+    m_instanceLods.push_back(0);
+    return m_instanceMatrices.size() - 1;
+}
+
+void Prefab::clearInstances() {
+    m_instanceMatrices.clear();
+    m_instanceMin.clear();
+    m_instanceMax.clear();
+    m_instanceLods.clear();
+    for (auto& matrices : m_visibleMatrices) {
+        matrices.clear();
+    }
+}
+
+size_t Prefab::getVisibleInstanceCount() const {
+    size_t count = 0;
+    for (const auto& matrices : m_visibleMatrices) {
+        count += matrices.size();
+    }
+    return count;
+}
+
+size_t Prefab::renderInstances(const Frustum& frustum, int modelLocation, const glm::vec3& viewPos) {
+    rebuildDirtyChunks();
+
+    for (auto& matrices : m_visibleMatrices) {
+        matrices.clear();
+    }
+    if (!m_blockRegistry) {
+        return 0;
+    }
+
+    m_instanceOrder.clear();
+    for (size_t i = 0; i < m_instanceMatrices.size(); i++) {
+        if (!frustum.intersectsAABB(m_instanceMin[i], m_instanceMax[i])) {
+            continue;
+        }
+
+        glm::vec3 center = (m_instanceMin[i] + m_instanceMax[i]) * 0.5f;
+        float distance = glm::length(center - viewPos);
+        m_instanceLods[i] = selectLodLevel(m_lodSettings, m_instanceLods[i], distance);
+        m_instanceOrder.emplace_back(distance, i);
+    }
+
+    // Instances are rasterised in buffer order, nearest first lets early depth
+    // testing skip the ones they hide
+    std::sort(m_instanceOrder.begin(), m_instanceOrder.end());
+    for (const auto& entry : m_instanceOrder) {
+        m_visibleMatrices[m_instanceLods[entry.second]].push_back(m_instanceMatrices[entry.second]);
+    }
+
+    size_t drawCalls = 0;
+    for (int lod = 0; lod < CHUNK_LOD_COUNT; lod++) {
+        const std::vector<glm::mat4>& matrices = m_visibleMatrices[lod];
+        if (matrices.empty()) {
+            continue;
+        }
+
+        unsigned int& buffer = m_instanceVBOs[lod];
+        if (buffer == 0) {
+            glGenBuffers(1, &buffer);
+        }
+
+        // Orphan the buffer every frame so the driver doesn't wait on last frame's draws
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        m_instanceCapacities[lod] = std::max(m_instanceCapacities[lod], matrices.size());
+        glBufferData(GL_ARRAY_BUFFER, m_instanceCapacities[lod] * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, matrices.size() * sizeof(glm::mat4), matrices.data());
+
+        for (const auto& chunk : m_chunks) {
+            if (chunk->getMesh().isEmpty()) {
+                continue;
+            }
+
+            // Builds the level first if it is stale
+            getLodMesh(*chunk, lod);
+            ChunkMesh& mesh = chunk->getMesh(lod);
+            if (mesh.isEmpty()) {
+                continue;
+            }
+
+            mesh.bindInstanceBuffer(buffer);
+
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(chunk->getOrigin()));
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
+            mesh.drawInstanced(matrices.size());
+            drawCalls++;
+        }
+    }
+
+    return drawCalls;
+}
+
+void Prefab::release() {
+    for (int lod = 0; lod < CHUNK_LOD_COUNT; lod++) {
+        if (m_instanceVBOs[lod] != 0) {
+            glDeleteBuffers(1, &m_instanceVBOs[lod]);
+            m_instanceVBOs[lod] = 0;
+        }
+        m_instanceCapacities[lod] = 0;
+    }
+
+    for (const auto& chunk : m_chunks) {
+        for (int lod = 0; lod < CHUNK_LOD_COUNT; lod++) {
+            chunk->getMesh(lod).release();
+            chunk->setLodStale(lod, lod > 0);
+        }
+    }
+}
+
+unsigned int Prefab::getInstancedShaderProgram(unsigned int features) {
+    // Prefab meshes hold every kind of block, leaves and glass included
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + "/chunk_instanced_vertex.glsl",
+        std::string(SHADER_DIR) + "/chunk_fragment.glsl",
+        features | ShaderUtils::ALPHA_TEST
+    );
+}
+
+unsigned int Prefab::getInstancedDepthShaderProgram() {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + "/chunk_instanced_vertex.glsl",
+        std::string(SHADER_DIR) + "/shadow_depth_fragment.glsl",
+        ShaderUtils::ALPHA_TEST
+    );
+}
+
+bool Prefab::getInstanceBounds(glm::vec3& min, glm::vec3& max) const {
+    if (m_instanceMin.empty()) {
+        return false;
+    }
+
+    min = m_instanceMin[0];
+    max = m_instanceMax[0];
+    for (size_t i = 1; i < m_instanceMin.size(); i++) {
+        min = glm::min(min, m_instanceMin[i]);
+        max = glm::max(max, m_instanceMax[i]);
+    }
+    return true;
+}
+
+} // namespace Zenith
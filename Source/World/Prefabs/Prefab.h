@@ -0,0 +1,81 @@
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include "World/Models/BaseModel.h"
+#include "World/Structures/StructureTemplate.h"
+#include "Utils/Frustum.h"
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// One placement of a prefab: where its anchor goes, quarter turns about Y and an
+// optional mirror along X (applied before the rotation)
+struct PrefabInstance {
+    glm::ivec3 position{0};
+    int rotation = 0;
+    bool mirror = false;
+};
+
+// A model meshed once and drawn at many placements with instanced draws. Voxels and
+// meshes are stored once per prefab; each instance only costs a matrix and a box.
+class Prefab : public BaseModel {
+public:
+    // Copy a template into a model sized to its bounding box
+    explicit Prefab(const StructureTemplate& structure);
+
+    // Add a placement, returns its index
+    size_t addInstance(const PrefabInstance& instance);
+    void clearInstances();
+
+    size_t getInstanceCount() const { return m_instanceMatrices.size(); }
+    size_t getVisibleInstanceCount() const;
+    size_t getVisibleInstanceCount(int lod) const { return m_visibleMatrices[lod].size(); }
+
+    // Matrix taking the prefab's model space to world space for a placement
+    glm::mat4 getInstanceMatrix(const PrefabInstance& instance) const;
+
+    // Cull the instances against the frustum and draw the visible ones nearest
+    // first, each with the detail level picked from its distance to viewPos (see
+    // setLodSettings()).
+    // The instanced shader must be bound with its shared uniforms set.
+    // Returns the number of draw calls issued.
+    size_t renderInstances(const Frustum& frustum, int modelLocation, const glm::vec3& viewPos);
+
+    // Delete the instance buffers and chunk meshes, must be called while the context is alive
+    void release();
+
+    // Shader program used by renderInstances(), with a mask of ShaderUtils::Feature
+    // compiled in. ALPHA_TEST is always added: prefab meshes hold leaves and glass.
+    static unsigned int getInstancedShaderProgram(unsigned int features = 0);
+
+    // Depth-only instanced program for the shadow pass (see ChunkMesh::getDepthShaderProgram())
+    static unsigned int getInstancedDepthShaderProgram();
+
+    // World space box around every placement, false if there are none
+    bool getInstanceBounds(glm::vec3& min, glm::vec3& max) const;
+
+private:
+    // Model space position of the template anchor
+    glm::ivec3 m_anchor;
+
+    // Per-instance placement, world bounds and current detail level
+    std::vector<glm::mat4> m_instanceMatrices;
+    std::vector<glm::vec3> m_instanceMin;
+    std::vector<glm::vec3> m_instanceMax;
+    std::vector<int> m_instanceLods;
+
+    // Distance and index of the instances that passed culling, sorted nearest first
+    std::vector<std::pair<float, size_t>> m_instanceOrder;
+
+    // Matrices of the instances that passed culling this frame, per detail level.
+    // Each level has its own instance buffer, bound to that level's chunk meshes.
+    std::array<std::vector<glm::mat4>, CHUNK_LOD_COUNT> m_visibleMatrices;
+    std::array<unsigned int, CHUNK_LOD_COUNT> m_instanceVBOs;
+    std::array<size_t, CHUNK_LOD_COUNT> m_instanceCapacities;
+};
+
+} // namespace Zenith
+
+#endif // PREFAB_H
@@ -0,0 +1,168 @@
+#include "PrefabLibrary.h"
+#include "Blocks/BlockTextureArray.h"
+#include "Blocks/Lightmap.h"
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <string>
+
+namespace Zenith {
+
+void PrefabLibrary::addInstance(const StructureTemplate& structure, const PrefabInstance& instance) {
+    auto it = m_prefabIndices.find(&structure);
+    if (it == m_prefabIndices.end()) {
+        auto prefab = std::make_unique<Prefab>(structure);
+        prefab->setLodSettings(m_lodSettings);
+        prefab->setLeavesMode(m_leavesMode);
+        if (m_blockRegistry) {
+            prefab->createVoxelObjects(*m_blockRegistry);
+        }
+
+        it = m_prefabIndices.emplace(&structure, m_prefabs.size()).first;
+        m_prefabs.push_back(std::move(prefab));
+    }
+
+    m_prefabs[it->second]->addInstance(instance);
+}
+
+void PrefabLibrary::clearInstances() {
+    for (const auto& prefab : m_prefabs) {
+        prefab->clearInstances();
+    }
+}
+
+void PrefabLibrary::setBlockRegistry(const BlockRegistryReader& blockRegistry) {
+    m_blockRegistry = &blockRegistry;
+    for (const auto& prefab : m_prefabs) {
+        prefab->createVoxelObjects(blockRegistry);
+    }
+}
+
+void PrefabLibrary::setLodSettings(const LodSettings& settings) {
+    m_lodSettings = settings;
+    for (const auto& prefab : m_prefabs) {
+        prefab->setLodSettings(settings);
+    }
+}
+
+void PrefabLibrary::setLeavesMode(LeavesMode mode) {
+    m_leavesMode = mode;
+    for (const auto& prefab : m_prefabs) {
+        prefab->setLeavesMode(mode);
+    }
+}
+
+void PrefabLibrary::render(const glm::mat4& view, const glm::mat4& projection,
+                           const glm::vec3& lightDir, const glm::vec3& lightColor,
+                           const glm::vec3& viewPos) {
+    m_stats = PrefabRenderStats();
+    m_stats.prefabs = m_prefabs.size();
+
+    unsigned int features = m_shaderFeatures & (ShaderUtils::AO | ShaderUtils::SPECULAR);
+    if (m_shadowMap) {
+        features |= ShaderUtils::SHADOWS;
+    }
+    if (m_fog.enabled) {
+        features |= ShaderUtils::FOG;
+    }
+    unsigned int program = Prefab::getInstancedShaderProgram(features);
+    if (program == 0 || m_prefabs.empty()) {
+        return;
+    }
+
+    glUseProgram(program);
+
+    // Uniforms shared by every prefab
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform3fv(glGetUniformLocation(program, "lightDir"), 1, glm::value_ptr(lightDir));
+    glUniform3fv(glGetUniformLocation(program, "lightColor"), 1, glm::value_ptr(lightColor));
+    glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, glm::value_ptr(viewPos));
+    glUniform1f(glGetUniformLocation(program, "ambientStrength"), m_ambientStrength);
+    glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, BlockTextureArray::shared().getTexture());
+    Lightmap::shared().bind(program, 1);
+    if (m_shadowMap) {
+        m_shadowMap->bind(program, 2);
+    }
+    if (m_fog.enabled) {
+        glUniform3fv(glGetUniformLocation(program, "fogColor"), 1, glm::value_ptr(m_fog.color));
+        glUniform1f(glGetUniformLocation(program, "fogStart"), m_fog.start);
+        glUniform1f(glGetUniformLocation(program, "fogEnd"), m_fog.end);
+    }
+
+    GLint modelLocation = glGetUniformLocation(program, "model");
+    Frustum frustum(projection * view);
+
+    for (const auto& prefab : m_prefabs) {
+        m_stats.drawCalls += prefab->renderInstances(frustum, modelLocation, viewPos);
+        m_stats.instances += prefab->getInstanceCount();
+        m_stats.visibleInstances += prefab->getVisibleInstanceCount();
+        for (int lod = 0; lod < CHUNK_LOD_COUNT; lod++) {
+            m_stats.instancesPerLod[lod] += prefab->getVisibleInstanceCount(lod);
+        }
+
+        int chunksX, chunksY, chunksZ;
+        prefab->getChunkGridSize(chunksX, chunksY, chunksZ);
+        for (int cy = 0; cy < chunksY; cy++) {
+            for (int cz = 0; cz < chunksZ; cz++) {
+                for (int cx = 0; cx < chunksX; cx++) {
+                    for (int lod = 0; lod < CHUNK_LOD_COUNT; lod++) {
+                        m_stats.meshVertices += prefab->getChunk(cx, cy, cz).getMesh(lod).getVertexCount();
+                    }
+                }
+            }
+        }
+    }
+}
+
+size_t PrefabLibrary::renderDepth(const glm::mat4& lightSpaceMatrix, const glm::vec3& viewPos) {
+    unsigned int program = Prefab::getInstancedDepthShaderProgram();
+    if (program == 0 || m_prefabs.empty()) {
+        return 0;
+    }
+
+    glUseProgram(program);
+
+    // The light's matrix takes world space straight to its clip space
+    glm::mat4 identity(1.0f);
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(identity));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
+    glUniform1i(glGetUniformLocation(program, "blockTextures"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, BlockTextureArray::shared().getTexture());
+
+    GLint modelLocation = glGetUniformLocation(program, "model");
+    Frustum frustum(lightSpaceMatrix);
+
+    // Detail levels still follow the distance to the camera, like the main pass
+    size_t drawCalls = 0;
+    for (const auto& prefab : m_prefabs) {
+        drawCalls += prefab->renderInstances(frustum, modelLocation, viewPos);
+    }
+    return drawCalls;
+}
+
+bool PrefabLibrary::getBounds(glm::vec3& min, glm::vec3& max) const {
+    bool found = false;
+    for (const auto& prefab : m_prefabs) {
+        glm::vec3 prefabMin, prefabMax;
+        if (!prefab->getInstanceBounds(prefabMin, prefabMax)) {
+            continue;
+        }
+        min = found ? glm::min(min, prefabMin) : prefabMin;
+        max = found ? glm::max(max, prefabMax) : prefabMax;
+        found = true;
+    }
+    return found;
+}
+
+void PrefabLibrary::release() {
+    for (const auto& prefab : m_prefabs) {
+        prefab->release();
+    }
+}
+
+} // namespace Zenith
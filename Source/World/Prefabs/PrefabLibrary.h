@@ -0,0 +1,93 @@
+#ifndef PREFAB_LIBRARY_H
+#define PREFAB_LIBRARY_H
+
+#include "Prefab.h"
+#include "Blocks/BlockRegistryReader.h"
+#include "World/Lighting/ShadowMap.h"
+#include "Utils/ShaderUtils.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenith {
+
+// Counters of the last PrefabLibrary::render()
+struct PrefabRenderStats {
+    size_t prefabs = 0;             // Unique meshed templates
+    size_t instances = 0;           // Placements of all prefabs
+    size_t visibleInstances = 0;    // Placements that passed frustum culling
+    std::array<size_t, CHUNK_LOD_COUNT> instancesPerLod{};
+    size_t drawCalls = 0;
+    size_t meshVertices = 0;        // Vertices stored on the GPU, independent of placements
+};
+
+// Prefabs keyed by the template they were built from, so every placement of the
+// same template shares one mesh. The templates must outlive the library.
+class PrefabLibrary {
+public:
+    PrefabLibrary() = default;
+
+    PrefabLibrary(const PrefabLibrary&) = delete;
+    PrefabLibrary& operator=(const PrefabLibrary&) = delete;
+
+    // Place a template, creating its prefab on first use
+    void addInstance(const StructureTemplate& structure, const PrefabInstance& instance);
+
+    // Drop every placement but keep the prefabs and their meshes
+    void clearInstances();
+
+    // Bind the registry used to mesh the prefabs
+    void setBlockRegistry(const BlockRegistryReader& blockRegistry);
+
+    // Level of detail settings applied to every prefab
+    void setLodSettings(const LodSettings& settings);
+
+    // Fast or fancy leaves for every prefab, see BaseModel::setLeavesMode()
+    void setLeavesMode(LeavesMode mode);
+
+    // Cull and draw every prefab with one instanced draw per block range
+    void render(const glm::mat4& view, const glm::mat4& projection,
+                const glm::vec3& lightDir, const glm::vec3& lightColor,
+                const glm::vec3& viewPos);
+
+    // Shadow map sampled by render(), nullptr for the program without shadow code.
+    // Must stay alive while set.
+    void setShadowMap(const ShadowMap* shadowMap) { m_shadowMap = shadowMap; }
+
+    // Share of the light colour every face gets regardless of the light direction
+    void setAmbientStrength(float strength) { m_ambientStrength = strength; }
+
+    // Optional shading features and fog, see BaseModel::setShaderFeatures() and
+    // BaseModel::setFog()
+    void setShaderFeatures(unsigned int features) { m_shaderFeatures = features; }
+    void setFog(const FogSettings& fog) { m_fog = fog; }
+
+    // Draw every placement inside the light's frustum into the bound shadow map.
+    // Returns the number of draw calls issued.
+    size_t renderDepth(const glm::mat4& lightSpaceMatrix, const glm::vec3& viewPos);
+
+    // World space box around every placement, false if there are none
+    bool getBounds(glm::vec3& min, glm::vec3& max) const;
+
+    const PrefabRenderStats& getStats() const { return m_stats; }
+
+    // Delete all GL objects, must be called while the context is alive
+    void release();
+
+private:
+    std::vector<std::unique_ptr<Prefab>> m_prefabs;
+    std::unordered_map<const StructureTemplate*, size_t> m_prefabIndices;
+    const BlockRegistryReader* m_blockRegistry = nullptr;
+    LodSettings m_lodSettings;
+    LeavesMode m_leavesMode = LeavesMode::FANCY;
+    const ShadowMap* m_shadowMap = nullptr;
+    float m_ambientStrength = 0.3f;
+    unsigned int m_shaderFeatures = ShaderUtils::AO | ShaderUtils::SPECULAR;
+    FogSettings m_fog;
+    PrefabRenderStats m_stats;
+};
+
+} // namespace Zenith
+
+#endif // PREFAB_LIBRARY_H
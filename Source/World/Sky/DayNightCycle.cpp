@@ -0,0 +1,101 @@
+#include "DayNightCycle.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Zenith {
+
+namespace {
+
+// The sun and moon travel the great circle through east and this axis, which
+// leans towards +z so noon light isn't straight down
+const glm::vec3 kEast(1.0f, 0.0f, 0.0f);
+const glm::vec3 kZenith = glm::normalize(glm::vec3(0.0f, 1.0f, 0.3f));
+
+// Lowest light angle above the horizon; grazing light would stretch shadows
+// across the whole world
+const float kMinLightAngle = glm::radians(8.0f);
+
+const glm::vec3 kNoonColor(1.0f, 0.97f, 0.9f);
+const glm::vec3 kHorizonColor(1.0f, 0.5f, 0.2f);
+const glm::vec3 kMoonColor(0.2f, 0.25f, 0.4f);
+const glm::vec3 kNightSkyTint(0.08f, 0.1f, 0.2f);
+
+} // namespace
+
+DayNightCycle::DayNightCycle()
+    : m_hours(10.0f), m_dayLength(600.0f), m_paused(false), m_shadowThreshold(0.5f),
+      m_shadowLightDir(0.0f), m_shadowLightDirChanged(false)
+{
+    update();
+}
+
+void DayNightCycle::advance(float seconds) {
+    if (m_paused || m_dayLength <= 0.0f) {
+        m_shadowLightDirChanged = false;
+        return;
+    }
+    m_hours = std::fmod(m_hours + seconds * 24.0f / m_dayLength, 24.0f);
+    update();
+}
+
+void DayNightCycle::setTime(float hours) {
+    m_hours = std::fmod(std::fmod(hours, 24.0f) + 24.0f, 24.0f);
+    update();
+}
+
+void DayNightCycle::setShadowThreshold(float degrees) {
+    m_shadowThreshold = std::max(degrees, 0.0f);
+}
+
+SkyLighting DayNightCycle::interpolate(const SkyLighting& a, const SkyLighting& b, float t) {
+    SkyLighting lighting;
+    lighting.lightDir = glm::normalize(glm::mix(a.lightDir, b.lightDir, t));
+    lighting.lightColor = glm::mix(a.lightColor, b.lightColor, t);
+    lighting.ambientStrength = glm::mix(a.ambientStrength, b.ambientStrength, t);
+    lighting.sunBrightness = glm::mix(a.sunBrightness, b.sunBrightness, t);
+    lighting.sunsetBlend = glm::mix(a.sunsetBlend, b.sunsetBlend, t);
+    lighting.skyTint = glm::mix(a.skyTint, b.skyTint, t);
+    return lighting;
+}
+
+void DayNightCycle::update() {
+    // Angle of the sun above the eastern horizon: 0 at 6:00, a right angle at noon,
+    // half a turn at 18:00. Below the horizon at night.
+    float angle = (m_hours - 6.0f) / 12.0f * glm::pi<float>();
+    float elevation = std::sin(angle);
+    bool day = elevation >= 0.0f;
+
+    // At night the moon follows the same path twelve hours behind
+    float lightAngle = angle;
+    if (!day) {
+        lightAngle = angle < 0.0f ? angle + glm::pi<float>() : angle - glm::pi<float>();
+    }
+    lightAngle = std::clamp(lightAngle, kMinLightAngle, glm::pi<float>() - kMinLightAngle);
+    glm::vec3 toLight = std::cos(lightAngle) * kEast + std::sin(lightAngle) * kZenith;
+    m_lighting.lightDir = -glm::normalize(toLight);
+
+    // Both lights fade out at the horizon, so the switch between them doesn't show
+    float horizon = 1.0f - glm::smoothstep(0.0f, 0.35f, std::abs(elevation));
+    if (day) {
+        m_lighting.lightColor = glm::mix(kNoonColor, kHorizonColor, horizon) * glm::smoothstep(-0.02f, 0.12f, elevation);
+    } else {
+        m_lighting.lightColor = kMoonColor * glm::smoothstep(0.0f, 0.12f, -elevation);
+    }
+
+    float daylight = glm::smoothstep(-0.1f, 0.25f, elevation);
+    m_lighting.ambientStrength = 0.12f + 0.18f * daylight;
+    m_lighting.sunBrightness = daylight;
+    m_lighting.sunsetBlend = 1.0f - glm::smoothstep(0.05f, 0.4f, std::abs(elevation));
+    m_lighting.skyTint = glm::mix(kNightSkyTint, glm::vec3(1.0f), glm::smoothstep(-0.25f, 0.1f, elevation));
+
+    // Step the shadow direction once the light has moved far enough
+    float cosine = glm::dot(m_lighting.lightDir, m_shadowLightDir);
+    m_shadowLightDirChanged = m_shadowLightDir == glm::vec3(0.0f)
+                           || std::acos(std::clamp(cosine, -1.0f, 1.0f)) > glm::radians(m_shadowThreshold);
+    if (m_shadowLightDirChanged) {
+        m_shadowLightDir = m_lighting.lightDir;
+    }
+}
+
+} // namespace Zenith
@@ -0,0 +1,73 @@
+#ifndef DAY_NIGHT_CYCLE_H
+#define DAY_NIGHT_CYCLE_H
+
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// Lighting at one time of day, everything the viewers feed to the renderers
+struct SkyLighting {
+    glm::vec3 lightDir{0.0f, -1.0f, 0.0f};  // Direction the light travels, from the sun (or the moon at night)
+    glm::vec3 lightColor{1.0f};
+    float ambientStrength = 0.3f;
+    float sunBrightness = 1.0f;     // Lightmap column, 0 (night) .. 1 (day), see Lightmap
+    float sunsetBlend = 0.0f;       // Share of the sunset sky over the clear one
+    glm::vec3 skyTint{1.0f};        // Multiplies the sky, dark blue at night
+};
+
+// Time of day in hours, 0..24, advanced by the simulation ticks. The sun rises in the east
+// (+x) at 6:00, peaks a little south of straight up at 12:00 and sets at 18:00;
+// between sunset and sunrise a dim moon lights from the opposite side.
+//
+// Shadow maps are expensive to re-render, so the cycle also keeps a shadow light
+// direction that only catches up with the light once it has moved more than a
+// threshold angle. Handing it to ShadowMap::update() re-renders the cascades
+// only on those steps.
+class DayNightCycle {
+public:
+    DayNightCycle();
+
+    // Move the clock forward by `seconds` of real time (nothing while paused)
+    void advance(float seconds);
+
+    void setTime(float hours);
+    float getTime() const { return m_hours; }
+
+    // Real seconds for a full day
+    void setDayLength(float seconds) { m_dayLength = seconds; }
+    float getDayLength() const { return m_dayLength; }
+
+    void setPaused(bool paused) { m_paused = paused; }
+    bool isPaused() const { return m_paused; }
+
+    // Angle the light has to move before the shadow direction follows, degrees
+    void setShadowThreshold(float degrees);
+    float getShadowThreshold() const { return m_shadowThreshold; }
+
+    const SkyLighting& getLighting() const { return m_lighting; }
+    const glm::vec3& getShadowLightDir() const { return m_shadowLightDir; }
+
+    // Whether the shadow direction stepped during the last advance() or setTime()
+    bool hasShadowLightDirChanged() const { return m_shadowLightDirChanged; }
+
+    // Lighting between two ticks' states, `t` from 0 (a) to 1 (b), for rendering
+    // between simulation ticks
+    static SkyLighting interpolate(const SkyLighting& a, const SkyLighting& b, float t);
+
+private:
+    // Recompute the lighting for m_hours and step the shadow direction if needed
+    void update();
+
+    float m_hours;
+    float m_dayLength;
+    bool m_paused;
+    float m_shadowThreshold;
+
+    SkyLighting m_lighting;
+    glm::vec3 m_shadowLightDir;
+    bool m_shadowLightDirChanged;
+};
+
+} // namespace Zenith
+
+#endif // DAY_NIGHT_CYCLE_H
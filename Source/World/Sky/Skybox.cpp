@@ -0,0 +1,271 @@
+#include "Skybox.h"
+#include "Utils/ShaderCache.h"
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+namespace Zenith {
+
+namespace {
+
+// GL cubemap face order: +X, -X, +Y, -Y, +Z, -Z
+const char* const kFaceNames[6] = { "px", "nx", "py", "ny", "pz", "nz" };
+
+// The faces the horizon runs through, across their middle
+const int kSideFaces[4] = { 0, 1, 4, 5 };
+
+// Unit cube, two triangles per face
+const float kCubeVertices[] = {
+    -1.0f,  1.0f, -1.0f,  -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,   1.0f,  1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+
+    -1.0f, -1.0f,  1.0f,  -1.0f, -1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+    -1.0f,  1.0f, -1.0f,  -1.0f,  1.0f,  1.0f,  -1.0f, -1.0f,  1.0f,
+
+     1.0f, -1.0f, -1.0f,   1.0f, -1.0f,  1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,   1.0f,  1.0f, -1.0f,   1.0f, -1.0f, -1.0f,
+
+    -1.0f, -1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,   1.0f, -1.0f,  1.0f,  -1.0f, -1.0f,  1.0f,
+
+    -1.0f,  1.0f, -1.0f,   1.0f,  1.0f, -1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,  -1.0f,  1.0f, -1.0f,
+
+    -1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f
+};
+
+std::string skyDirectory() {
+    return std::string(ASSETS_DIR) + "/Clouds";
+}
+
+} // namespace
+
+Skybox::Skybox()
+    : m_current(0), m_blendAmount(0.0f), m_tint(1.0f), m_VAO(0), m_VBO(0)
+{
+}
+
+void Skybox::setSky(const std::string& name) {
+    m_skyName = name;
+
+    auto it = m_cubemaps.find(name);
+    if (it != m_cubemaps.end() && it->second != 0) {
+        m_current = it->second;
+    }
+    requestSky(name);
+}
+
+void Skybox::setBlend(const std::string& name, float amount) {
+    m_blendSky = name;
+    m_blendAmount = std::clamp(amount, 0.0f, 1.0f);
+    if (m_blendAmount > 0.0f) {
+        requestSky(name);
+    }
+}
+
+void Skybox::requestSky(const std::string& name) {
+    if (m_cubemaps.count(name) != 0) {
+        return;
+    }
+
+    for (const auto& pending : m_pending) {
+        if (pending->name == name) {
+            return;
+        }
+    }
+
+    auto pending = std::make_unique<PendingSky>();
+    pending->name = name;
+    for (int face = 0; face < 6; face++) {
+        std::string path = skyDirectory() + "/" + name + "/" + kFaceNames[face] + ".png";
+        pending->faces[face] = std::async(std::launch::async, &Skybox::decodeFace, path);
+    }
+    m_pending.push_back(std::move(pending));
+}
+
+std::vector<std::string> Skybox::findSkies() {
+    std::vector<std::string> names;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(skyDirectory(), error)) {
+        if (entry.is_directory()) {
+            names.push_back(entry.path().filename().string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+Skybox::FaceImage Skybox::decodeFace(const std::string& path) {
+    FaceImage image;
+    int components;
+    unsigned char* data = stbi_load(path.c_str(), &image.width, &image.height, &components, 4);
+    if (!data) {
+        std::cerr << "Sky face failed to load: " << path << std::endl;
+        return image;
+    }
+
+    image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * 4);
+    stbi_image_free(data);
+
+    // The middle quarter of the rows, averaged here so the main thread doesn't
+    // walk the pixels when the sky is uploaded
+    int firstRow = image.height * 3 / 8;
+    int lastRow = std::max(image.height * 5 / 8, firstRow + 1);
+    glm::dvec3 sum(0.0);
+    for (int row = firstRow; row < lastRow; row++) {
+        const unsigned char* pixel = image.pixels.data() + static_cast<size_t>(row) * image.width * 4;
+        for (int column = 0; column < image.width; column++, pixel += 4) {
+            sum += glm::dvec3(pixel[0], pixel[1], pixel[2]);
+        }
+    }
+    image.horizonColor = glm::vec3(sum / (255.0 * image.width * (lastRow - firstRow)));
+    return image;
+}
+
+void Skybox::finishPending() {
+    for (size_t i = 0; i < m_pending.size();) {
+        PendingSky& pending = *m_pending[i];
+        bool ready = std::all_of(pending.faces.begin(), pending.faces.end(), [](const std::future<FaceImage>& face) {
+            return face.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+        if (!ready) {
+            i++;
+            continue;
+        }
+
+        std::array<FaceImage, 6> faces;
+        bool complete = true;
+        for (int face = 0; face < 6; face++) {
+            faces[face] = pending.faces[face].get();
+            complete = complete && !faces[face].pixels.empty() && faces[face].width == faces[0].width
+                    && faces[face].height == faces[0].height;
+        }
+
+        // Failures are cached too so a missing sky is only reported once
+        unsigned int cubemap = 0;
+        if (complete) {
+            glGenTextures(1, &cubemap);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+            for (int face = 0; face < 6; face++) {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGBA8, faces[face].width, faces[face].height,
+                             0, GL_RGBA, GL_UNSIGNED_BYTE, faces[face].pixels.data());
+            }
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+            glm::vec3 horizon(0.0f);
+            for (int face : kSideFaces) {
+                horizon += faces[face].horizonColor * 0.25f;
+            }
+            m_horizonColors[cubemap] = horizon;
+        } else {
+            std::cerr << "Sky \"" << pending.name << "\" is incomplete, keeping the current sky" << std::endl;
+        }
+
+        m_cubemaps[pending.name] = cubemap;
+        if (pending.name == m_skyName && cubemap != 0) {
+            m_current = cubemap;
+        }
+        m_pending.erase(m_pending.begin() + i);
+    }
+}
+
+bool Skybox::getHorizonColor(glm::vec3& color) const {
+    auto current = m_horizonColors.find(m_current);
+    if (current == m_horizonColors.end()) {
+        return false;
+    }
+    color = current->second;
+
+    // Same weighting as render()
+    auto blend = m_cubemaps.find(m_blendSky);
+    if (blend != m_cubemaps.end() && blend->second != 0) {
+        color = glm::mix(color, m_horizonColors.at(blend->second), m_blendAmount);
+    }
+    color *= m_tint;
+    return true;
+}
+
+void Skybox::render(const glm::mat4& view, const glm::mat4& projection) {
+    finishPending();
+
+    unsigned int program = getShaderProgram();
+    if (program == 0 || m_current == 0) {
+        return;
+    }
+
+    if (m_VAO == 0) {
+        glGenVertexArrays(1, &m_VAO);
+        glGenBuffers(1, &m_VBO);
+        glBindVertexArray(m_VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(kCubeVertices), kCubeVertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    }
+
+    glUseProgram(program);
+
+    // The sky follows the camera's rotation but never its position
+    glm::mat4 rotation = glm::mat4(glm::mat3(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(rotation));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1i(glGetUniformLocation(program, "skybox"), 0);
+    glUniform1i(glGetUniformLocation(program, "skyboxBlend"), 1);
+    glUniform3fv(glGetUniformLocation(program, "tint"), 1, glm::value_ptr(m_tint));
+
+    // Until the blend sky has loaded the current one stands in with no weight
+    auto blend = m_cubemaps.find(m_blendSky);
+    unsigned int blendCubemap = blend != m_cubemaps.end() ? blend->second : 0;
+    glUniform1f(glGetUniformLocation(program, "blend"), blendCubemap != 0 ? m_blendAmount : 0.0f);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, blendCubemap != 0 ? blendCubemap : m_current);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, m_current);
+
+    // The vertex shader puts the cube on the far plane, where the cleared depth
+    // is: LEQUAL passes only where nothing was drawn
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+}
+
+void Skybox::release() {
+    for (auto& entry : m_cubemaps) {
+        if (entry.second != 0) {
+            glDeleteTextures(1, &entry.second);
+        }
+    }
+    m_cubemaps.clear();
+    m_horizonColors.clear();
+    m_current = 0;
+
+    if (m_VAO != 0) {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+        m_VAO = 0;
+        m_VBO = 0;
+    }
+}
+
+unsigned int Skybox::getShaderProgram() {
+    return ShaderCache::shared().getProgram(
+        std::string(SHADER_DIR) + "/skybox.vert",
+        std::string(SHADER_DIR) + "/skybox.frag"
+    );
+}
+
+} // namespace Zenith
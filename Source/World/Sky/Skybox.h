@@ -0,0 +1,107 @@
+#ifndef SKYBOX_H
+#define SKYBOX_H
+
+#include <array>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// Cubemap sky drawn behind everything with skybox.vert/.frag. Skies are the six
+// faces in Assets/Clouds/<name>/{px,nx,py,ny,pz,nz}.png, decoded on worker threads
+// and uploaded once complete; until then the previous sky keeps drawing, so
+// switching never blocks a frame. Each sky is loaded once and kept.
+//
+// A second sky can be faded over the first (the sunset over the clear sky as the
+// sun goes down) and the result multiplied by a tint, for night.
+//
+// Like the other GL owners the destructor makes no GL calls, call release().
+class Skybox {
+public:
+    Skybox();
+    ~Skybox() = default;
+
+    Skybox(const Skybox&) = delete;
+    Skybox& operator=(const Skybox&) = delete;
+
+    // Show the named sky, starting to load it if needed
+    void setSky(const std::string& name);
+    const std::string& getSkyName() const { return m_skyName; }
+
+    // Whether the requested sky is still being decoded
+    bool isLoading() const { return m_cubemaps.count(m_skyName) == 0; }
+
+    // Fade another sky over the current one by `amount` (0..1), loading it if
+    // needed. Nothing is blended until it has loaded.
+    void setBlend(const std::string& name, float amount);
+
+    // Colour the sky is multiplied by
+    void setTint(const glm::vec3& tint) { m_tint = tint; }
+
+    // Average colour around the horizon of the sky as drawn, blend and tint
+    // included, for fog that fades terrain into the sky behind it. False until
+    // a sky has loaded.
+    bool getHorizonColor(glm::vec3& color) const;
+
+    // Names of the sky folders under Assets/Clouds, sorted
+    static std::vector<std::string> findSkies();
+
+    // Upload a finished sky, then draw the current one. Call after the opaque
+    // geometry and before the translucent faces: the sky sits on the far plane
+    // and only fills uncovered pixels, and glass has to blend over it.
+    void render(const glm::mat4& view, const glm::mat4& projection);
+
+    // Delete the cubemaps and the cube, must be called while the context is alive
+    void release();
+
+private:
+    struct FaceImage {
+        std::vector<unsigned char> pixels;  // RGBA
+        int width = 0;
+        int height = 0;
+        glm::vec3 horizonColor{0.0f};       // Average of the middle rows, 0..1
+    };
+
+    // A sky being decoded, one task per face in GL cubemap order
+    struct PendingSky {
+        std::string name;
+        std::array<std::future<FaceImage>, 6> faces;
+    };
+
+    // Start decoding a sky unless it is loaded or already decoding
+    void requestSky(const std::string& name);
+
+    static FaceImage decodeFace(const std::string& path);
+
+    // Upload the pending skies whose faces are all decoded
+    void finishPending();
+
+    static unsigned int getShaderProgram();
+
+    // Cubemaps by sky name, 0 when a sky failed to load
+    std::unordered_map<std::string, unsigned int> m_cubemaps;
+
+    // Horizon colour of each loaded cubemap, averaged over the side faces
+    std::unordered_map<unsigned int, glm::vec3> m_horizonColors;
+
+    // Skies still decoding. A sky switched away from keeps decoding here, waiting
+    // on its tasks would stall the frame.
+    std::vector<std::unique_ptr<PendingSky>> m_pending;
+    std::string m_skyName;      // Requested sky
+    unsigned int m_current;     // Cubemap drawn, the previous sky while loading or if it failed
+
+    std::string m_blendSky;
+    float m_blendAmount;
+    glm::vec3 m_tint;
+
+    unsigned int m_VAO;
+    unsigned int m_VBO;
+};
+
+} // namespace Zenith
+
+#endif // SKYBOX_H
@@ -0,0 +1,230 @@
+#include "StructurePlacer.h"
+#include <algorithm>
+#include <chrono>
+
+namespace Zenith {
+
+namespace {
+
+const int kHutTypeCount = 4;
+
+// Ground blocks a tree can grow from
+bool isFertile(const std::string& blockType) {
+    return blockType == "GRASS" || blockType == "DIRT" || blockType == "PODZOL" || blockType == "SNOW";
+}
+
+// Random stream of a chunk column for one placement pass
+uint64_t columnStream(int cx, int cz, uint64_t pass) {
+    return (pass << 62) | (static_cast<uint64_t>(cz & 0x3FFFFFFF) << 32) | static_cast<uint32_t>(cx);
+}
+
+// Expected count to an actual count: the integer part plus one more with the
+// probability of the fractional part
+int drawCount(PhiloxRng& rng, float expected) {
+    if (expected <= 0.0f) {
+        return 0;
+    }
+    int count = static_cast<int>(expected);
+    if (rng.uniformFloat() < expected - count) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+StructurePlacer::StructurePlacer(const StructureTemplateCache& cache)
+    : m_cache(cache)
+{
+}
+
+StructurePlacementStats StructurePlacer::place(TerrainModel& terrain, uint64_t seed,
+                                               const StructurePlacementSettings& settings,
+                                               std::vector<StructurePlacement>* placements) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    StructurePlacementStats stats;
+    if (!m_cache.isBuilt()) {
+        return stats;
+    }
+
+    int width, height, depth;
+    terrain.getDimensions(width, height, depth);
+    int columnsX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    int columnsZ = (depth + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    std::vector<Footprint> placed;
+
+    // Huts go first: they need flat ground and trees can grow around them
+    for (int pass = 0; pass < 2; pass++) {
+        bool huts = (pass == 0);
+
+        for (int cz = 0; cz < columnsZ; cz++) {
+            for (int cx = 0; cx < columnsX; cx++) {
+                PhiloxRng rng(seed, columnStream(cx, cz, pass + 1));
+
+                int centerX = std::min(cx * CHUNK_SIZE + CHUNK_SIZE / 2, width - 1);
+                int centerZ = std::min(cz * CHUNK_SIZE + CHUNK_SIZE / 2, depth - 1);
+                const BiomeSettings& biome = getBiomeSettings(terrain.getBiome(centerX, centerZ));
+
+                float expected = huts ? biome.hutsPerChunk * settings.hutDensity
+                                      : biome.treesPerChunk * settings.treeDensity;
+                int count = drawCount(rng, expected);
+
+                for (int i = 0; i < count; i++) {
+                    int x = cx * CHUNK_SIZE + rng.uniformInt(0, CHUNK_SIZE - 1);
+                    int z = cz * CHUNK_SIZE + rng.uniformInt(0, CHUNK_SIZE - 1);
+                    if (x >= width || z >= depth) {
+                        continue;
+                    }
+
+                    bool accepted = huts ? tryPlaceHut(terrain, rng, x, z, placed, settings, stats)
+                                         : tryPlaceTree(terrain, rng, x, z, placed, settings, stats, placements);
+                    if (!accepted) {
+                        stats.rejected++;
+                    }
+                }
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return stats;
+}
+
+size_t StructurePlacer::stamp(BaseModel& target, const StructureTemplate& tmpl, const glm::ivec3& anchor, bool replaceSolid,
+                              int rotation, bool mirror) {
+    size_t written = 0;
+    for (const StructureVoxel& voxel : tmpl.voxels) {
+        glm::ivec3 offset = StructureTemplate::transformOffset(glm::ivec3(voxel.x, voxel.y, voxel.z), rotation, mirror);
+        int x = anchor.x + offset.x;
+        int y = anchor.y + offset.y;
+        int z = anchor.z + offset.z;
+
+        if (!target.isWithinBounds(x, y, z)) {
+            continue;
+        }
+        if (!replaceSolid && target.getBlockId(x, y, z) != 0) {
+            continue;
+        }
+        if (target.addVoxel(x, y, z, tmpl.palette[voxel.block])) {
+            written++;
+        }
+    }
+    return written;
+}
+
+bool StructurePlacer::isSpaceFree(const std::vector<Footprint>& placed, int x, int z, int radius, bool hut,
+                                  const StructurePlacementSettings& settings) const {
+    for (const Footprint& other : placed) {
+        int required = (hut || other.hut) ? radius + other.radius : settings.minTreeSpacing;
+        int dx = other.x - x;
+        int dz = other.z - z;
+        if (dx * dx + dz * dz < required * required) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StructurePlacer::tryPlaceHut(TerrainModel& terrain, PhiloxRng& rng, int x, int z, std::vector<Footprint>& placed,
+                                  const StructurePlacementSettings& settings, StructurePlacementStats& stats) const {
+    HutType type = static_cast<HutType>(rng.uniformInt(0, kHutTypeCount - 1));
+    const StructureTemplate& tmpl = m_cache.getHut(type, rng.uniformInt(0, m_cache.getVariantsPerType() - 1));
+    int rotation = rng.uniformInt(0, 3);
+    bool mirror = rng.uniformInt(0, 1) == 1;
+    if (tmpl.voxels.empty()) {
+        return false;
+    }
+
+    glm::ivec3 boundsMin, boundsMax;
+    tmpl.getPlacedBounds(rotation, mirror, boundsMin, boundsMax);
+
+    int radius = std::max({ -boundsMin.x, boundsMax.x, -boundsMin.z, boundsMax.z }) + 1;
+    if (!isSpaceFree(placed, x, z, radius, true, settings)) {
+        return false;
+    }
+
+    // The whole floor must be on fairly flat ground inside the terrain
+    int lowest = 0;
+    int highest = -1;
+    for (int dz = boundsMin.z; dz <= boundsMax.z; dz++) {
+        for (int dx = boundsMin.x; dx <= boundsMax.x; dx++) {
+            int surface = terrain.getSurfaceHeight(x + dx, z + dz);
+            if (surface < 0) {
+                return false;
+            }
+            if (highest < 0) {
+                lowest = highest = surface;
+            } else {
+                lowest = std::min(lowest, surface);
+                highest = std::max(highest, surface);
+            }
+        }
+    }
+
+    int width, height, depth;
+    terrain.getDimensions(width, height, depth);
+    if (highest - lowest > settings.maxHutSlope || highest + boundsMax.y >= height) {
+        return false;
+    }
+
+    // Fill the gap under the floor, then let the floor replace the highest ground
+    const std::string& filler = getBiomeSettings(terrain.getBiome(x, z)).fillerBlock;
+    for (const StructureVoxel& voxel : tmpl.voxels) {
+        if (voxel.y != 0) {
+            continue;
+        }
+        glm::ivec3 offset = StructureTemplate::transformOffset(glm::ivec3(voxel.x, 0, voxel.z), rotation, mirror);
+        int columnX = x + offset.x;
+        int columnZ = z + offset.z;
+        for (int y = terrain.getSurfaceHeight(columnX, columnZ) + 1; y < highest; y++) {
+            if (terrain.addVoxel(columnX, y, columnZ, filler)) {
+                stats.voxelsStamped++;
+            }
+        }
+    }
+
+    stats.voxelsStamped += stamp(terrain, tmpl, glm::ivec3(x, highest, z), true, rotation, mirror);
+    stats.hutsPlaced++;
+    placed.push_back({ x, z, radius, true });
+    return true;
+}
+
+bool StructurePlacer::tryPlaceTree(TerrainModel& terrain, PhiloxRng& rng, int x, int z, std::vector<Footprint>& placed,
+                                   const StructurePlacementSettings& settings, StructurePlacementStats& stats,
+                                   std::vector<StructurePlacement>* placements) const {
+    const BiomeSettings& biome = getBiomeSettings(terrain.getBiome(x, z));
+    if (biome.treeTypes.empty()) {
+        return false;
+    }
+
+    TreeType type = biome.treeTypes[rng.uniformInt(0, static_cast<int>(biome.treeTypes.size()) - 1)];
+    int variant = rng.uniformInt(0, m_cache.getVariantsPerType() - 1);
+    int rotation = rng.uniformInt(0, 3);
+    bool mirror = rng.uniformInt(0, 1) == 1;
+
+    int ground = terrain.getSurfaceHeight(x, z);
+    if (ground < 0 || !isFertile(terrain.getBlockType(x, ground, z))) {
+        return false;
+    }
+    if (!isSpaceFree(placed, x, z, 1, false, settings)) {
+        return false;
+    }
+
+    const StructureTemplate& tmpl = m_cache.getTree(type, variant);
+    glm::ivec3 anchor(x, ground + 1, z);
+    if (settings.instanceTrees) {
+        if (placements) {
+            placements->push_back({ &tmpl, anchor, rotation, mirror });
+        }
+        stats.treesInstanced++;
+    } else {
+        stats.voxelsStamped += stamp(terrain, tmpl, anchor, false, rotation, mirror);
+    }
+    stats.treesPlaced++;
+    placed.push_back({ x, z, 1, false });
+    return true;
+}
+
+} // namespace Zenith
@@ -0,0 +1,81 @@
+#ifndef STRUCTURE_PLACER_H
+#define STRUCTURE_PLACER_H
+
+#include "StructureTemplateCache.h"
+#include "World/Terrain/TerrainModel.h"
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// Scales applied on top of each biome's structure density
+struct StructurePlacementSettings {
+    float treeDensity = 1.0f;
+    float hutDensity = 1.0f;
+    int minTreeSpacing = 3;     // Minimum distance between two trunks, in blocks
+    int maxHutSlope = 2;        // Largest ground height difference under a hut floor
+    bool instanceTrees = false; // Record trees as placements instead of stamping their voxels
+};
+
+// A structure left to be drawn as a prefab instance instead of stamped voxels
+struct StructurePlacement {
+    const StructureTemplate* structure;
+    glm::ivec3 anchor;
+    int rotation;               // Quarter turns about Y
+    bool mirror;                // Mirrored along X before the rotation
+};
+
+struct StructurePlacementStats {
+    size_t treesPlaced = 0;
+    size_t treesInstanced = 0;  // Part of treesPlaced recorded as placements
+    size_t hutsPlaced = 0;
+    size_t rejected = 0;        // Candidates dropped for bad ground or spacing
+    size_t voxelsStamped = 0;
+    double milliseconds = 0.0;
+};
+
+// Scatters cached tree and hut templates over a terrain. Candidates are drawn per
+// 16x16 chunk column from its own random stream, so the layout depends only on the
+// seed; structures are stamped voxel by voxel and may spill into neighbouring chunks.
+// Every structure gets a random quarter turn and mirror so cached variants repeat less.
+class StructurePlacer {
+public:
+    explicit StructurePlacer(const StructureTemplateCache& cache);
+
+    // With settings.instanceTrees, trees are appended to `placements` (if given)
+    // instead of being written into the terrain
+    StructurePlacementStats place(TerrainModel& terrain, uint64_t seed,
+                                  const StructurePlacementSettings& settings = StructurePlacementSettings(),
+                                  std::vector<StructurePlacement>* placements = nullptr) const;
+
+    // Write a template with its anchor at `anchor`, clipped to the model bounds.
+    // Cells already holding a block are kept unless `replaceSolid` is set.
+    // Returns the number of blocks written.
+    static size_t stamp(BaseModel& target, const StructureTemplate& tmpl, const glm::ivec3& anchor, bool replaceSolid,
+                        int rotation = 0, bool mirror = false);
+
+private:
+    // Footprint of an accepted structure, used for the spacing test
+    struct Footprint {
+        int x, z;
+        int radius;
+        bool hut;
+    };
+
+    bool isSpaceFree(const std::vector<Footprint>& placed, int x, int z, int radius, bool hut,
+                     const StructurePlacementSettings& settings) const;
+
+    bool tryPlaceHut(TerrainModel& terrain, PhiloxRng& rng, int x, int z, std::vector<Footprint>& placed,
+                     const StructurePlacementSettings& settings, StructurePlacementStats& stats) const;
+
+    bool tryPlaceTree(TerrainModel& terrain, PhiloxRng& rng, int x, int z, std::vector<Footprint>& placed,
+                      const StructurePlacementSettings& settings, StructurePlacementStats& stats,
+                      std::vector<StructurePlacement>* placements) const;
+
+    const StructureTemplateCache& m_cache;
+};
+
+} // namespace Zenith
+
+#endif // STRUCTURE_PLACER_H
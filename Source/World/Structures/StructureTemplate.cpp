@@ -0,0 +1,61 @@
+#include "StructureTemplate.h"
+#include <unordered_map>
+
+namespace Zenith {
+
+StructureTemplate StructureTemplate::fromModel(const BaseModel& model) {
+    StructureTemplate result;
+
+    int width, height, depth;
+    model.getDimensions(width, height, depth);
+    glm::ivec3 anchor(width / 2, 0, depth / 2);
+
+    std::unordered_map<std::string, uint16_t> paletteLookup;
+    std::vector<VoxelPosition> positions = model.getOccupiedPositions();
+    result.voxels.reserve(positions.size());
+
+    bool first = true;
+    for (const VoxelPosition& pos : positions) {
+        std::string blockType = model.getBlockType(pos.x, pos.y, pos.z);
+
+        auto it = paletteLookup.find(blockType);
+        if (it == paletteLookup.end()) {
+            it = paletteLookup.emplace(blockType, static_cast<uint16_t>(result.palette.size())).first;
+            result.palette.push_back(blockType);
+        }
+
+        glm::ivec3 offset = glm::ivec3(pos.x, pos.y, pos.z) - anchor;
+        result.voxels.push_back({ static_cast<int16_t>(offset.x), static_cast<int16_t>(offset.y),
+                                  static_cast<int16_t>(offset.z), it->second });
+
+        if (first) {
+            result.minOffset = result.maxOffset = offset;
+            first = false;
+        } else {
+            result.minOffset = glm::min(result.minOffset, offset);
+            result.maxOffset = glm::max(result.maxOffset, offset);
+        }
+    }
+
+    return result;
+}
+
+glm::ivec3 StructureTemplate::transformOffset(const glm::ivec3& offset, int rotation, bool mirror) {
+    static const int kCos[4] = { 1, 0, -1, 0 };
+    static const int kSin[4] = { 0, 1, 0, -1 };
+
+    int turn = rotation & 3;
+    int x = mirror ? -offset.x : offset.x;
+    return glm::ivec3(kCos[turn] * x + kSin[turn] * offset.z,
+                      offset.y,
+                      -kSin[turn] * x + kCos[turn] * offset.z);
+}
+
+void StructureTemplate::getPlacedBounds(int rotation, bool mirror, glm::ivec3& min, glm::ivec3& max) const {
+    glm::ivec3 a = transformOffset(minOffset, rotation, mirror);
+    glm::ivec3 b = transformOffset(maxOffset, rotation, mirror);
+    min = glm::min(a, b);
+    max = glm::max(a, b);
+}
+
+} // namespace Zenith
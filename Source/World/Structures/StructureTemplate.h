@@ -0,0 +1,42 @@
+#ifndef STRUCTURE_TEMPLATE_H
+#define STRUCTURE_TEMPLATE_H
+
+#include "World/Models/BaseModel.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Zenith {
+
+// One block of a template, relative to the template anchor
+struct StructureVoxel {
+    int16_t x, y, z;
+    uint16_t block;  // Index into StructureTemplate::palette
+};
+
+// Compact copy of a generated model that can be stamped into the world many times.
+// The anchor is the centre of the model's ground layer, where trees have their
+// trunk and huts the middle of their floor.
+struct StructureTemplate {
+    std::vector<std::string> palette;
+    std::vector<StructureVoxel> voxels;
+
+    // Bounding box of the voxels relative to the anchor (inclusive)
+    glm::ivec3 minOffset{0};
+    glm::ivec3 maxOffset{0};
+
+    // Copy the occupied cells of a model
+    static StructureTemplate fromModel(const BaseModel& model);
+
+    // Offset of a voxel after mirroring along X, then turning `rotation` quarter
+    // turns about Y (the same placement Prefab::getInstanceMatrix() builds)
+    static glm::ivec3 transformOffset(const glm::ivec3& offset, int rotation, bool mirror);
+
+    // Bounding box of the voxels once placed with a rotation and mirror
+    void getPlacedBounds(int rotation, bool mirror, glm::ivec3& min, glm::ivec3& max) const;
+};
+
+} // namespace Zenith
+
+#endif // STRUCTURE_TEMPLATE_H
@@ -0,0 +1,87 @@
+#include "StructureTemplateCache.h"
+#include "World/Models/ModelBatchGenerator.h"
+#include <algorithm>
+#include <chrono>
+
+namespace Zenith {
+
+namespace {
+
+const int kTreeTypeCount = 6;
+const int kHutTypeCount = 4;
+
+// Decorrelates the per-type batches generated from one seed
+uint64_t typeSeed(uint64_t seed, int typeIndex, bool hut) {
+    return seed ^ ((static_cast<uint64_t>(typeIndex) + (hut ? 0x100u : 0u)) * 0x9E3779B97F4A7C15ull);
+}
+
+} // namespace
+
+StructureTemplateCache::StructureTemplateCache(int variantsPerType)
+    : m_variantsPerType(std::max(1, variantsPerType)),
+      m_buildMilliseconds(0.0)
+{
+}
+
+void StructureTemplateCache::build(uint64_t seed, unsigned int threadCount) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ModelBatchGenerator generator(threadCount);
+    m_trees.assign(kTreeTypeCount, {});
+    m_huts.assign(kHutTypeCount, {});
+
+    for (int type = 0; type < kTreeTypeCount; type++) {
+        TreeBatchSettings settings;
+        settings.randomType = false;
+        settings.type = static_cast<TreeType>(type);
+
+        auto trees = generator.generateTrees(m_variantsPerType, typeSeed(seed, type, false), settings);
+        for (const auto& tree : trees) {
+            m_trees[type].push_back(StructureTemplate::fromModel(*tree));
+        }
+    }
+
+    for (int type = 0; type < kHutTypeCount; type++) {
+        HutBatchSettings settings;
+        settings.randomType = false;
+        settings.type = static_cast<HutType>(type);
+
+        auto huts = generator.generateHuts(m_variantsPerType, typeSeed(seed, type, true), settings);
+        for (const auto& hut : huts) {
+            m_huts[type].push_back(StructureTemplate::fromModel(*hut));
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_buildMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+const StructureTemplate& StructureTemplateCache::getTree(TreeType type, int variant) const {
+    const auto& variants = m_trees[static_cast<int>(type)];
+    return variants[variant % variants.size()];
+}
+
+const StructureTemplate& StructureTemplateCache::getHut(HutType type, int variant) const {
+    const auto& variants = m_huts[static_cast<int>(type)];
+    return variants[variant % variants.size()];
+}
+
+size_t StructureTemplateCache::getTemplateCount() const {
+    size_t count = 0;
+    for (const auto& variants : m_trees) count += variants.size();
+    for (const auto& variants : m_huts) count += variants.size();
+    return count;
+}
+
+size_t StructureTemplateCache::getVoxelCount() const {
+    size_t count = 0;
+    for (const auto& variants : m_trees) {
+        for (const StructureTemplate& tmpl : variants) count += tmpl.voxels.size();
+    }
+    for (const auto& variants : m_huts) {
+        for (const StructureTemplate& tmpl : variants) count += tmpl.voxels.size();
+    }
+    return count;
+}
+
+} // namespace Zenith
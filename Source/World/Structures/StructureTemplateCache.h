@@ -0,0 +1,46 @@
+#ifndef STRUCTURE_TEMPLATE_CACHE_H
+#define STRUCTURE_TEMPLATE_CACHE_H
+
+#include "StructureTemplate.h"
+#include "World/Models/TreeModel.h"
+#include "World/Models/HutModel.h"
+#include <cstdint>
+#include <vector>
+
+namespace Zenith {
+
+// Pre-generated variants of every tree and hut type. Placement picks a variant per
+// instance instead of generating a new model, so a forest of thousands of trees
+// costs `variantsPerType` generations per type.
+class StructureTemplateCache {
+public:
+    explicit StructureTemplateCache(int variantsPerType = 8);
+
+    // Generate all variants from `seed` on `threadCount` threads (0 = all cores)
+    void build(uint64_t seed, unsigned int threadCount = 0);
+
+    bool isBuilt() const { return !m_trees.empty(); }
+    int getVariantsPerType() const { return m_variantsPerType; }
+
+    // Variant `variant` (taken modulo the variant count) of a type
+    const StructureTemplate& getTree(TreeType type, int variant) const;
+    const StructureTemplate& getHut(HutType type, int variant) const;
+
+    // Totals for the viewers' stats
+    size_t getTemplateCount() const;
+    size_t getVoxelCount() const;
+    double getBuildMilliseconds() const { return m_buildMilliseconds; }
+
+private:
+    int m_variantsPerType;
+
+    // [type][variant]
+    std::vector<std::vector<StructureTemplate>> m_trees;
+    std::vector<std::vector<StructureTemplate>> m_huts;
+
+    double m_buildMilliseconds;
+};
+
+} // namespace Zenith
+
+#endif // STRUCTURE_TEMPLATE_CACHE_H
@@ -0,0 +1,39 @@
+#include "Biome.h"
+#include <iostream>
+
+namespace Zenith {
+
+namespace {
+
+const BiomeSettings kBiomes[BIOME_COUNT] = {
+    // name,       surface,  filler,     stone,       base, variation, ridged, trees, huts, tree types
+    { "PLAINS",    "GRASS",  "DIRT",     "STONE",     0.30f, 0.08f, false, 0.3f, 0.08f, { TreeType::OAK, TreeType::BIRCH } },
+    { "FOREST",    "GRASS",  "DIRT",     "STONE",     0.32f, 0.12f, false, 4.0f, 0.03f, { TreeType::OAK, TreeType::BIRCH, TreeType::DARK_OAK } },
+    { "MOUNTAINS", "GRASS",  "DIRT",     "STONE",     0.40f, 0.45f, true,  0.8f, 0.02f, { TreeType::SPRUCE, TreeType::OAK } },
+    { "DESERT",    "SAND",   "SAND",     "SANDSTONE", 0.28f, 0.06f, false, 0.0f, 0.04f, { } },
+    { "TAIGA",     "SNOW",   "DIRT",     "STONE",     0.34f, 0.15f, false, 2.5f, 0.03f, { TreeType::SPRUCE } },
+    { "JUNGLE",    "GRASS",  "DIRT",     "STONE",     0.32f, 0.14f, false, 3.5f, 0.02f, { TreeType::JUNGLE, TreeType::ACACIA } },
+};
+
+} // namespace
+
+const BiomeSettings& getBiomeSettings(BiomeType biome) {
+    return kBiomes[static_cast<int>(biome)];
+}
+
+const char* getBiomeName(BiomeType biome) {
+    return kBiomes[static_cast<int>(biome)].name;
+}
+
+BiomeType parseBiomeName(const std::string& name, BiomeType fallback) {
+    for (int i = 0; i < BIOME_COUNT; i++) {
+        if (name == kBiomes[i].name) {
+            return static_cast<BiomeType>(i);
+        }
+    }
+
+    std::cerr << "Unknown biome '" << name << "', using " << getBiomeName(fallback) << std::endl;
+    return fallback;
+}
+
+} // namespace Zenith
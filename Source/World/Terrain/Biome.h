@@ -0,0 +1,55 @@
+#ifndef BIOME_H
+#define BIOME_H
+
+#include "World/Models/TreeModel.h"
+#include <string>
+#include <vector>
+
+namespace Zenith {
+
+// Biomes the terrain generator can produce
+enum class BiomeType {
+    PLAINS,
+    FOREST,
+    MOUNTAINS,
+    DESERT,
+    TAIGA,
+    JUNGLE
+};
+
+constexpr int BIOME_COUNT = 6;
+
+// Shape of the terrain and what grows on it for one biome
+struct BiomeSettings {
+    const char* name;
+
+    // Terrain layers, top to bottom
+    std::string surfaceBlock;
+    std::string fillerBlock;
+    std::string stoneBlock;
+
+    // Ground height is (baseHeight + noise * heightVariation) * world height
+    float baseHeight;
+    float heightVariation;
+    bool ridged;   // Sharp ridge noise instead of rolling hills
+
+    // Expected number of structures per 16x16 chunk column
+    float treesPerChunk;
+    float hutsPerChunk;
+
+    // Tree types picked uniformly for this biome (empty = no trees)
+    std::vector<TreeType> treeTypes;
+};
+
+// Settings of a biome
+const BiomeSettings& getBiomeSettings(BiomeType biome);
+
+// Name used in the config file ("MOUNTAINS", ...) and in the viewers
+const char* getBiomeName(BiomeType biome);
+
+// Parse a config name, returns `fallback` for unknown names
+BiomeType parseBiomeName(const std::string& name, BiomeType fallback = BiomeType::PLAINS);
+
+} // namespace Zenith
+
+#endif // BIOME_H
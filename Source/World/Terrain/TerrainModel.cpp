@@ -0,0 +1,144 @@
+#include "TerrainModel.h"
+#include "Utils/Random.h"
+#include <algorithm>
+#include <cmath>
+
+#define STB_PERLIN_IMPLEMENTATION
+#include "stb_perlin.h"
+
+namespace Zenith {
+
+namespace {
+
+// Blocks per period of the height noise
+const float kHeightScale = 64.0f;
+
+// Mountain columns above this fraction of the world height get a snow cap
+const float kSnowLine = 0.75f;
+
+float smoothStep(float edge0, float edge1, float x) {
+    float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+} // namespace
+
+TerrainModel::TerrainModel(int width, int height, int depth)
+    : BaseModel(width, height, depth),
+      m_defaultBiome(BiomeType::PLAINS),
+      m_heightOffset(0.0f),
+      m_biomeOffset(0.0f)
+{
+}
+
+void TerrainModel::generateTerrain(uint64_t seed, const TerrainSettings& settings) {
+    clear();
+
+    PhiloxRng rng(seed);
+    m_heightOffset = glm::vec3(rng.uniformFloat(), rng.uniformFloat(), rng.uniformFloat()) * 256.0f;
+    m_biomeOffset = glm::vec3(rng.uniformFloat(), rng.uniformFloat(), rng.uniformFloat()) * 256.0f;
+    m_defaultBiome = settings.defaultBiome;
+
+    m_surfaceHeights.assign(static_cast<size_t>(m_width) * m_depth, -1);
+    m_biomes.assign(static_cast<size_t>(m_width) * m_depth, settings.defaultBiome);
+
+    for (int z = 0; z < m_depth; z++) {
+        for (int x = 0; x < m_width; x++) {
+            BiomeType biome;
+            float height = sampleHeight(static_cast<float>(x), static_cast<float>(z), settings, biome);
+            int surfaceY = std::clamp(static_cast<int>(height), 1, m_height - 1);
+
+            const BiomeSettings& biomeSettings = getBiomeSettings(biome);
+            std::string surfaceBlock = biomeSettings.surfaceBlock;
+            std::string fillerBlock = biomeSettings.fillerBlock;
+            if (biome == BiomeType::MOUNTAINS && surfaceY > m_height * kSnowLine) {
+                surfaceBlock = "SNOW";
+                fillerBlock = biomeSettings.stoneBlock;
+            }
+
+            addVoxel(x, 0, z, "BEDROCK");
+            for (int y = 1; y <= surfaceY; y++) {
+                if (y == surfaceY) {
+                    addVoxel(x, y, z, surfaceBlock);
+                } else if (y >= surfaceY - 3) {
+                    addVoxel(x, y, z, fillerBlock);
+                } else {
+                    addVoxel(x, y, z, biomeSettings.stoneBlock);
+                }
+            }
+
+            size_t column = static_cast<size_t>(z) * m_width + x;
+            m_surfaceHeights[column] = surfaceY;
+            m_biomes[column] = biome;
+        }
+    }
+}
+
+int TerrainModel::getSurfaceHeight(int x, int z) const {
+    if (x < 0 || x >= m_width || z < 0 || z >= m_depth || m_surfaceHeights.empty()) {
+        return -1;
+    }
+    return m_surfaceHeights[static_cast<size_t>(z) * m_width + x];
+}
+
+BiomeType TerrainModel::getBiome(int x, int z) const {
+    if (x < 0 || x >= m_width || z < 0 || z >= m_depth || m_biomes.empty()) {
+        return m_defaultBiome;
+    }
+    return m_biomes[static_cast<size_t>(z) * m_width + x];
+}
+
+float TerrainModel::sampleHeight(float x, float z, const TerrainSettings& settings, BiomeType& biome) const {
+    if (settings.forceBiome) {
+        biome = settings.defaultBiome;
+        return sampleBiomeHeight(biome, x, z);
+    }
+
+    // Low frequency noise laid out over the biome list; columns near the edge of a
+    // band blend their height with the neighbouring biome so there are no cliffs
+    float noise = stb_perlin_fbm_noise3((x + m_biomeOffset.x) / settings.biomeScale, m_biomeOffset.y,
+                                        (z + m_biomeOffset.z) / settings.biomeScale, 2.0f, 0.5f, 2);
+    float band = std::clamp(noise + 0.5f, 0.0f, 0.9999f) * BIOME_COUNT;
+    int index = static_cast<int>(band);
+    float fraction = band - index;
+    biome = static_cast<BiomeType>(index);
+
+    float height = sampleBiomeHeight(biome, x, z);
+    float blendWidth = std::clamp(settings.biomeBlendFactor, 0.0f, 1.0f) * 0.5f;
+    if (blendWidth <= 0.0f) {
+        return height;
+    }
+
+    int neighbour = -1;
+    float weight = 0.0f;
+    if (fraction > 1.0f - blendWidth && index + 1 < BIOME_COUNT) {
+        neighbour = index + 1;
+        weight = 0.5f * smoothStep(1.0f - blendWidth, 1.0f, fraction);
+    } else if (fraction < blendWidth && index > 0) {
+        neighbour = index - 1;
+        weight = 0.5f * (1.0f - smoothStep(0.0f, blendWidth, fraction));
+    }
+
+    if (neighbour >= 0) {
+        float neighbourHeight = sampleBiomeHeight(static_cast<BiomeType>(neighbour), x, z);
+        height += (neighbourHeight - height) * weight;
+    }
+    return height;
+}
+
+float TerrainModel::sampleBiomeHeight(BiomeType biome, float x, float z) const {
+    const BiomeSettings& settings = getBiomeSettings(biome);
+    float nx = (x + m_heightOffset.x) / kHeightScale;
+    float nz = (z + m_heightOffset.z) / kHeightScale;
+
+    float noise;
+    if (settings.ridged) {
+        noise = stb_perlin_ridge_noise3(nx, m_heightOffset.y, nz, 2.0f, 0.5f, 1.0f, 4) * 2.0f - 1.0f;
+    } else {
+        noise = stb_perlin_fbm_noise3(nx, m_heightOffset.y, nz, 2.0f, 0.5f, 4);
+    }
+
+    return (settings.baseHeight + noise * settings.heightVariation) * m_height;
+}
+
+} // namespace Zenith
@@ -0,0 +1,51 @@
+#ifndef TERRAIN_MODEL_H
+#define TERRAIN_MODEL_H
+
+#include "World/Models/BaseModel.h"
+#include "Biome.h"
+#include <cstdint>
+#include <vector>
+
+namespace Zenith {
+
+// How the terrain picks its biomes
+struct TerrainSettings {
+    BiomeType defaultBiome = BiomeType::PLAINS;
+    bool forceBiome = false;        // Use defaultBiome everywhere
+    float biomeBlendFactor = 0.5f;  // Width of the height transition between biomes, 0..1
+    float biomeScale = 160.0f;      // Size of a biome region in blocks
+};
+
+// Heightmap terrain filling a BaseModel volume, one biome per column
+class TerrainModel : public BaseModel {
+public:
+    TerrainModel(int width, int height, int depth);
+
+    // Fill the volume from `seed`; the same seed and settings give the same terrain
+    void generateTerrain(uint64_t seed, const TerrainSettings& settings = TerrainSettings());
+
+    // Y of the topmost terrain block of a column (-1 outside the terrain)
+    int getSurfaceHeight(int x, int z) const;
+
+    // Biome of a column (the default biome outside the terrain)
+    BiomeType getBiome(int x, int z) const;
+
+private:
+    // Ground height of a column before it is clamped to the volume
+    float sampleHeight(float x, float z, const TerrainSettings& settings, BiomeType& biome) const;
+
+    // Height of one biome's ground at a position
+    float sampleBiomeHeight(BiomeType biome, float x, float z) const;
+
+    std::vector<int> m_surfaceHeights;
+    std::vector<BiomeType> m_biomes;
+    BiomeType m_defaultBiome;
+
+    // Noise offsets derived from the seed (stb_perlin has no seeded fbm)
+    glm::vec3 m_heightOffset;
+    glm::vec3 m_biomeOffset;
+};
+
+} // namespace Zenith
+
+#endif // TERRAIN_MODEL_H
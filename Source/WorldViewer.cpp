@@ -0,0 +1,699 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// ImGui headers
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+
+#include "Camera/WindowManager.h"
+#include "Camera/FreeCamera.h"
+#include "GameControls/KeyboardHandler.h"
+#include "GameControls/MouseHandler.h"
+#include "ConfigManager/ConfigReader.h"
+#include "Blocks/BlockRegistryReader.h"
+#include "Blocks/BlockTextureArray.h"
+#include "Blocks/Lightmap.h"
+#include "World/Terrain/TerrainModel.h"
+#include "World/Structures/StructurePlacer.h"
+#include "World/Prefabs/PrefabLibrary.h"
+#include "World/Lighting/ShadowMap.h"
+#include "World/Sky/Skybox.h"
+#include "World/Sky/DayNightCycle.h"
+#include "World/Chunks/ChunkDrawBatcher.h"
+#include "Utils/FrameClock.h"
+#include "Utils/ShaderCache.h"
+#include "Utils/ShaderUtils.h"
+
+// Callback function for window resize
+void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
+    glViewport(0, 0, width, height);
+}
+
+int main() {
+    // Initialize GLFW
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+
+    // Configure GLFW, asking for 4.3 first so the vertex pulling renderer is available
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Load configuration
+    Config config = loadConfig(std::string(CONFIG_DIR) + "/config.json");
+
+    // Create window, falling back to a 3.3 context (a failed attempt terminates GLFW)
+    WindowManager windowManager;
+    GLFWwindow* window = windowManager.createWindow(config);
+    if (!window && glfwInit()) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        window = windowManager.createWindow(config);
+    }
+    if (!window) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    // Initially start with mouse unlocked for ImGui interaction
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+    // Register window callbacks
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+    // Initialize GLAD
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    // Initialize ImGui
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO(); (void)io;
+    ImGui::StyleColorsDark();
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplOpenGL3_Init("#version 330");
+
+    // Configure OpenGL
+    glEnable(GL_DEPTH_TEST);
+
+    // Load block registry
+    Zenith::BlockRegistryReader blockRegistry;
+    if (!blockRegistry.loadRegistry()) {
+        std::cerr << "Failed to load block registry" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    // World volume from the grid config
+    int worldWidth = config.gridConfig.vox_width;
+    int worldHeight = config.gridConfig.vox_maxHeight;
+    int worldDepth = config.gridConfig.vox_depth;
+
+    // Terrain settings from the world config
+    Zenith::TerrainSettings terrainSettings;
+    terrainSettings.defaultBiome = Zenith::parseBiomeName(config.world.defaultBiome);
+    terrainSettings.forceBiome = config.world.forceBiome;
+    terrainSettings.biomeBlendFactor = config.world.biomeBlendFactor;
+
+    Zenith::StructurePlacementSettings placementSettings;
+    placementSettings.instanceTrees = true;
+
+    // Structure templates are generated once and reused by every placement
+    int seed = 1337;
+    Zenith::StructureTemplateCache templateCache(8);
+    templateCache.build(static_cast<uint64_t>(seed));
+    Zenith::StructurePlacer placer(templateCache);
+
+    // Quality preset: fast leaves are solid and drawn with the opaque pass, fancy
+    // ones keep their holes in an alpha tested pass. Fast also runs the shader
+    // permutation without ambient occlusion and specular highlights.
+    const char* qualityNames[] = { "Fast", "Fancy" };
+    Zenith::LeavesMode leavesMode = config.performance.quality == "fast" ? Zenith::LeavesMode::FAST
+                                                                         : Zenith::LeavesMode::FANCY;
+    const unsigned int fancyShaderFeatures = ShaderUtils::AO | ShaderUtils::SPECULAR;
+    unsigned int shaderFeatures = leavesMode == Zenith::LeavesMode::FAST ? 0u : fancyShaderFeatures;
+
+    // Distance fog, in the sky's horizon colour so far terrain fades into the sky
+    Zenith::FogSettings fog;
+
+    auto terrain = std::make_unique<Zenith::TerrainModel>(worldWidth, worldHeight, worldDepth);
+    terrain->setLeavesMode(leavesMode);
+    terrain->setShaderFeatures(shaderFeatures);
+    terrain->createVoxelObjects(blockRegistry);
+    terrain->setOcclusionCulling(true);
+    terrain->setVisibilityCulling(true);
+
+    // Instanced trees share one mesh per template variant
+    Zenith::PrefabLibrary prefabLibrary;
+    prefabLibrary.setLeavesMode(leavesMode);
+    prefabLibrary.setShaderFeatures(shaderFeatures);
+    prefabLibrary.setBlockRegistry(blockRegistry);
+    std::vector<Zenith::StructurePlacement> placements;
+
+    double terrainMilliseconds = 0.0;
+    Zenith::StructurePlacementStats placementStats;
+
+    auto generateWorld = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        terrain->generateTerrain(static_cast<uint64_t>(seed), terrainSettings);
+        auto end = std::chrono::high_resolution_clock::now();
+        terrainMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+        placements.clear();
+        placementStats = placer.place(*terrain, static_cast<uint64_t>(seed), placementSettings, &placements);
+
+        prefabLibrary.clearInstances();
+        for (const Zenith::StructurePlacement& placement : placements) {
+            Zenith::PrefabInstance instance;
+            instance.position = placement.anchor;
+            instance.rotation = placement.rotation;
+            instance.mirror = placement.mirror;
+            prefabLibrary.addInstance(*placement.structure, instance);
+        }
+
+        std::cout << "Generated world with " << terrain->getVoxelCount() << " blocks, "
+                  << placementStats.treesPlaced << " trees and " << placementStats.hutsPlaced << " huts" << std::endl;
+    };
+    generateWorld();
+
+    // Create camera above the middle of the world, looking along it
+    FreeCamera camera(glm::vec3(worldWidth * 0.5f, worldHeight + 10.0f, worldDepth * 0.9f), config.camera.up);
+    camera.setPitch(-30.0f);
+    camera.setMovementSpeed(20.0f);
+    float cameraSpeed = camera.getMovementSpeed();
+
+    // Create input handlers
+    KeyboardHandler keyHandler;
+    MouseHandler mouseHandler;
+    mouseHandler.processMouseMovement(window, camera);
+
+    // Biome names for ImGui
+    const char* biomeNames[Zenith::BIOME_COUNT];
+    for (int i = 0; i < Zenith::BIOME_COUNT; i++) {
+        biomeNames[i] = Zenith::getBiomeName(static_cast<Zenith::BiomeType>(i));
+    }
+
+    // Level of detail, shared by the terrain chunks and the prefabs
+    Zenith::LodSettings lodSettings;
+    lodSettings.enabled = true;
+    bool showLodOverlay = false;
+    const ImU32 lodColors[Zenith::CHUNK_LOD_COUNT] = {
+        IM_COL32(80, 255, 80, 255), IM_COL32(255, 255, 80, 255),
+        IM_COL32(255, 160, 40, 255), IM_COL32(255, 60, 60, 255)
+    };
+
+    // Chunk faces as vertex buffers or as face records pulled by the vertex shader
+    bool vertexPulling = false;
+
+    // Lighting follows the time of day: sun and moon direction, light colour,
+    // ambient, the lightmap's day column and the sky
+    Zenith::DayNightCycle dayNightCycle;
+    dayNightCycle.setTime(config.timeOfDay.startHour);
+    dayNightCycle.setDayLength(config.timeOfDay.dayLength);
+    dayNightCycle.setShadowThreshold(config.timeOfDay.shadowThreshold);
+    int shadowSteps = 0;
+
+    // Directional light shadows. Turning them off also swaps in chunk programs
+    // built without the shadow code.
+    bool shadowsEnabled = config.shadows.enabled;
+    int shadowResolution = config.shadows.resolution;
+    int shadowCascades = config.shadows.cascades;
+    const int shadowResolutions[] = { 1024, 2048, 4096 };
+    Zenith::ShadowMap shadowMap;
+    size_t shadowDrawCalls = 0;
+
+    // Sky cubemap from the config, switchable between the folders in Assets/Clouds
+    Zenith::Skybox skybox;
+    skybox.setSky(config.skyname);
+    std::vector<std::string> skyNames = Zenith::Skybox::findSkies();
+
+    // Fixed-step simulation with rendering between its last two states; the
+    // frame limit only applies without vsync, which paces the loop by itself
+    Zenith::FrameClock frameClock(60.0);
+    frameClock.setFrameLimit(config.performance.vsync ? 0 : config.performance.targetFPS);
+    Zenith::SkyLighting previousLighting = dayNightCycle.getLighting();
+
+    // Mouse lock state
+    bool mouseLocked = false;
+    bool altKeyPressed = false;
+
+    // Main render loop
+    while (!glfwWindowShouldClose(window)) {
+        // Real frame time drives input, the simulation runs in the ticks due
+        int ticks = frameClock.beginFrame();
+        float deltaTime = frameClock.getFrameSeconds();
+
+        // Swap in shaders edited since the last frame, before any pass uses them
+        Zenith::ShaderCache::shared().reloadChanged();
+
+        // Start the ImGui frame
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::GetIO().FontGlobalScale = 2.5f;  // Scale up the ImGui font size
+        ImGui::NewFrame();
+
+        // Check if ImGui wants to capture mouse input before processing Alt key
+        bool imguiWantsMouse = ImGui::GetIO().WantCaptureMouse;
+
+        // Only process Alt key if ImGui is not capturing mouse
+        if (!imguiWantsMouse) {
+            // Process Alt key to toggle mouse lock
+            if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS && !altKeyPressed) {
+                altKeyPressed = true;
+                mouseLocked = !mouseLocked;
+                glfwSetInputMode(window, GLFW_CURSOR, mouseLocked ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+                // Reset first mouse to avoid camera jump when toggling
+                if (mouseLocked) {
+                    double xpos, ypos;
+                    glfwGetCursorPos(window, &xpos, &ypos);
+                    mouseHandler.setLastX(static_cast<float>(xpos));
+                    mouseHandler.setLastY(static_cast<float>(ypos));
+                    mouseHandler.setFirstMouse(true);
+                }
+            }
+            else if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_RELEASE) {
+                altKeyPressed = false;
+            }
+        }
+
+        // Create ImGui window for world control
+        ImGui::SetNextWindowSize(ImVec2(1500, 1000), ImGuiCond_FirstUseEver);
+        ImGui::Begin("World Viewer");
+
+        // Add a hint about Alt key functionality
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f),
+                          "Press [ALT] to %s mouse | Mouse is %s | ImGui wants mouse: %s",
+                          mouseLocked ? "unlock" : "lock",
+                          mouseLocked ? "locked" : "unlocked",
+                          imguiWantsMouse ? "Yes" : "No");
+        ImGui::Separator();
+
+        // Process camera movement only when mouse is locked and ImGui is not capturing input
+        if (mouseLocked && !imguiWantsMouse) {
+            // Handle keyboard input for camera movement
+            keyHandler.processInput(window, camera, deltaTime);
+
+            // Handle mouse movement for camera
+            double xpos, ypos;
+            glfwGetCursorPos(window, &xpos, &ypos);
+
+            float xposf = static_cast<float>(xpos);
+            float yposf = static_cast<float>(ypos);
+
+            if (mouseHandler.isFirstMouse()) {
+                mouseHandler.setLastX(xposf);
+                mouseHandler.setLastY(yposf);
+                mouseHandler.setFirstMouse(false);
+            }
+
+            float xoffset = xposf - mouseHandler.getLastX();
+            float yoffset = mouseHandler.getLastY() - yposf;
+
+            mouseHandler.setLastX(xposf);
+            mouseHandler.setLastY(yposf);
+
+            camera.processMouseMovement(xoffset, yoffset);
+        }
+
+        // Terrain controls
+        ImGui::Text("World Seed:");
+        bool worldChanged = ImGui::InputInt("##WorldSeed", &seed);
+
+        worldChanged |= ImGui::Checkbox("Force Biome", &terrainSettings.forceBiome);
+
+        int biomeIndex = static_cast<int>(terrainSettings.defaultBiome);
+        if (ImGui::BeginCombo("##Biome", biomeNames[biomeIndex])) {
+            for (int i = 0; i < Zenith::BIOME_COUNT; i++) {
+                bool isSelected = (biomeIndex == i);
+                if (ImGui::Selectable(biomeNames[i], isSelected)) {
+                    terrainSettings.defaultBiome = static_cast<Zenith::BiomeType>(i);
+                    worldChanged = true;
+                }
+                if (isSelected) {
+                    ImGui::SetItemDefaultFocus();
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::SliderFloat("Biome Blend", &terrainSettings.biomeBlendFactor, 0.0f, 1.0f);
+
+        // Structure density controls
+        ImGui::Separator();
+        ImGui::SliderFloat("Tree Density", &placementSettings.treeDensity, 0.0f, 4.0f);
+        ImGui::SliderFloat("Hut Density", &placementSettings.hutDensity, 0.0f, 8.0f);
+        ImGui::SliderInt("Tree Spacing", &placementSettings.minTreeSpacing, 1, 8);
+        worldChanged |= ImGui::Checkbox("Instance Trees", &placementSettings.instanceTrees);
+
+        if (ImGui::Button("Regenerate World") || worldChanged) {
+            generateWorld();
+        }
+
+        if (ImGui::SliderFloat("Camera Speed", &cameraSpeed, 1.0f, 100.0f)) {
+            camera.setMovementSpeed(cameraSpeed);
+        }
+
+        // Level of detail controls
+        ImGui::Separator();
+        ImGui::Checkbox("Enable LOD", &lodSettings.enabled);
+        ImGui::SameLine();
+        ImGui::Checkbox("Show LOD Overlay", &showLodOverlay);
+        ImGui::SliderFloat("LOD 2x Distance", &lodSettings.distances[0], 16.0f, 512.0f);
+        ImGui::SliderFloat("LOD 4x Distance", &lodSettings.distances[1], lodSettings.distances[0], 512.0f);
+        ImGui::SliderFloat("LOD 8x Distance", &lodSettings.distances[2], lodSettings.distances[1], 512.0f);
+        ImGui::SliderFloat("LOD Hysteresis", &lodSettings.hysteresis, 0.0f, 32.0f);
+        terrain->setLodSettings(lodSettings);
+        prefabLibrary.setLodSettings(lodSettings);
+
+        int quality = leavesMode == Zenith::LeavesMode::FAST ? 0 : 1;
+        if (ImGui::Combo("Quality", &quality, qualityNames, 2)) {
+            leavesMode = quality == 0 ? Zenith::LeavesMode::FAST : Zenith::LeavesMode::FANCY;
+            shaderFeatures = quality == 0 ? 0u : fancyShaderFeatures;
+            terrain->setLeavesMode(leavesMode);
+            terrain->setShaderFeatures(shaderFeatures);
+            prefabLibrary.setLeavesMode(leavesMode);
+            prefabLibrary.setShaderFeatures(shaderFeatures);
+        }
+
+        // Renderer path, the toggle snaps back if the context can't pull vertices
+        if (ImGui::Checkbox("Vertex Pulling (GL 4.3)", &vertexPulling)) {
+            if (!terrain->setMeshLayout(vertexPulling ? Zenith::ChunkMeshLayout::FACE_RECORDS
+                                                      : Zenith::ChunkMeshLayout::QUAD_VERTICES)) {
+                vertexPulling = false;
+            }
+        }
+        bool occlusionCulling = terrain->isOcclusionCullingEnabled();
+        if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling)) {
+            terrain->setOcclusionCulling(occlusionCulling);
+        }
+        bool visibilityCulling = terrain->isVisibilityCullingEnabled();
+        if (ImGui::Checkbox("Cave Culling", &visibilityCulling)) {
+            terrain->setVisibilityCulling(visibilityCulling);
+        }
+        bool depthPrePass = terrain->isDepthPrePassEnabled();
+        if (ImGui::Checkbox("Depth Pre-Pass", &depthPrePass)) {
+            terrain->setDepthPrePass(depthPrePass);
+        }
+        int frameLimit = frameClock.getFrameLimit();
+        if (ImGui::SliderInt("Frame Limit (0 = off)", &frameLimit, 0, 240)) {
+            frameClock.setFrameLimit(frameLimit);
+        }
+        bool shaderHotReload = Zenith::ShaderCache::shared().isHotReloadEnabled();
+        if (ImGui::Checkbox("Shader Hot Reload", &shaderHotReload)) {
+            Zenith::ShaderCache::shared().setHotReload(shaderHotReload);
+        }
+        // Debug colourings of the chunks, nothing is built or drawn for them when off
+        if (ImGui::BeginCombo("Terrain Debug View", Zenith::BaseModel::getDebugViewName(terrain->getDebugView()))) {
+            for (int i = 0; i < Zenith::CHUNK_DEBUG_VIEW_COUNT; i++) {
+                Zenith::ChunkDebugView debugView = static_cast<Zenith::ChunkDebugView>(i);
+                if (ImGui::Selectable(Zenith::BaseModel::getDebugViewName(debugView), terrain->getDebugView() == debugView)) {
+                    terrain->setDebugView(debugView);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        bool multiDraw = Zenith::ChunkDrawBatcher::shared().isMultiDrawEnabled();
+        if (ImGui::Checkbox("Multi-Draw Indirect (GL 4.3)", &multiDraw)) {
+            Zenith::ChunkDrawBatcher::shared().setMultiDrawEnabled(multiDraw);
+        }
+        ImGui::Checkbox("Shadows", &shadowsEnabled);
+        ImGui::SameLine();
+        char resolutionLabel[16];
+        snprintf(resolutionLabel, sizeof(resolutionLabel), "%d", shadowResolution);
+        if (ImGui::BeginCombo("Shadow Map Size", resolutionLabel)) {
+            for (int resolution : shadowResolutions) {
+                snprintf(resolutionLabel, sizeof(resolutionLabel), "%d", resolution);
+                if (ImGui::Selectable(resolutionLabel, resolution == shadowResolution)) {
+                    shadowResolution = resolution;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SliderInt("Shadow Cascades", &shadowCascades, 1, Zenith::MAX_SHADOW_CASCADES);
+        if (ImGui::BeginCombo("Sky", skybox.getSkyName().c_str())) {
+            for (const std::string& skyName : skyNames) {
+                if (ImGui::Selectable(skyName.c_str(), skyName == skybox.getSkyName())) {
+                    skybox.setSky(skyName);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        if (skybox.isLoading()) {
+            ImGui::SameLine();
+            ImGui::Text("(loading)");
+        }
+        ImGui::Checkbox("Fog", &fog.enabled);
+        if (fog.enabled) {
+            ImGui::SliderFloat("Fog Start", &fog.start, 0.0f, 512.0f);
+            ImGui::SliderFloat("Fog End", &fog.end, fog.start, 1024.0f);
+        }
+        float timeOfDay = dayNightCycle.getTime();
+        if (ImGui::SliderFloat("Time of Day", &timeOfDay, 0.0f, 24.0f, "%.2f h")) {
+            dayNightCycle.setTime(timeOfDay);
+            previousLighting = dayNightCycle.getLighting();   // Jump there, no blend from the old time
+        }
+        bool timePaused = dayNightCycle.isPaused();
+        if (ImGui::Checkbox("Pause Time", &timePaused)) {
+            dayNightCycle.setPaused(timePaused);
+        }
+        float dayLength = dayNightCycle.getDayLength();
+        if (ImGui::SliderFloat("Day Length (s)", &dayLength, 30.0f, 3600.0f, "%.0f")) {
+            dayNightCycle.setDayLength(dayLength);
+        }
+        float shadowThreshold = dayNightCycle.getShadowThreshold();
+        if (ImGui::SliderFloat("Shadow Step (deg)", &shadowThreshold, 0.0f, 5.0f, "%.2f")) {
+            dayNightCycle.setShadowThreshold(shadowThreshold);
+        }
+
+        // Display world information
+        ImGui::Separator();
+        ImGui::Text("World Information:");
+
+        int chunksX, chunksY, chunksZ;
+        terrain->getChunkGridSize(chunksX, chunksY, chunksZ);
+        glm::vec3 cameraPos = camera.getPosition();
+
+        ImGui::Text("World Dimensions: %d x %d x %d (%d chunks)", worldWidth, worldHeight, worldDepth,
+                    chunksX * chunksY * chunksZ);
+        ImGui::Text("Total Blocks: %zu", terrain->getVoxelCount());
+        ImGui::Text("Biome Under Camera: %s",
+                    Zenith::getBiomeName(terrain->getBiome(static_cast<int>(cameraPos.x), static_cast<int>(cameraPos.z))));
+        ImGui::Text("Terrain: %.2f ms", terrainMilliseconds);
+        ImGui::Text("Templates: %zu (%zu blocks) built in %.2f ms", templateCache.getTemplateCount(),
+                    templateCache.getVoxelCount(), templateCache.getBuildMilliseconds());
+        ImGui::Text("Placed: %zu trees, %zu huts, %zu rejected", placementStats.treesPlaced,
+                    placementStats.hutsPlaced, placementStats.rejected);
+        ImGui::Text("Stamped: %zu blocks in %.2f ms", placementStats.voxelsStamped, placementStats.milliseconds);
+
+        const Zenith::PrefabRenderStats& prefabStats = prefabLibrary.getStats();
+        ImGui::Text("Prefabs: %zu meshes (%zu vertices), %zu/%zu instances visible, %zu draw calls",
+                    prefabStats.prefabs, prefabStats.meshVertices, prefabStats.visibleInstances,
+                    prefabStats.instances, prefabStats.drawCalls);
+
+        const Zenith::ChunkRenderStats& renderStats = terrain->getLastRenderStats();
+        ImGui::Text("Chunks Drawn: %zu (LOD 1x/2x/4x/8x: %zu/%zu/%zu/%zu), %zu triangles",
+                    renderStats.chunksDrawn, renderStats.chunksPerLod[0], renderStats.chunksPerLod[1],
+                    renderStats.chunksPerLod[2], renderStats.chunksPerLod[3], renderStats.triangles);
+        size_t chunksInFrustum = renderStats.chunksDrawn + renderStats.chunksOccluded;
+        ImGui::Text("Chunks Culled: %zu by frustum, %zu of %zu occluded (%.0f%%), %zu queries",
+                    renderStats.chunksCulled, renderStats.chunksOccluded, chunksInFrustum,
+                    chunksInFrustum > 0 ? 100.0 * renderStats.chunksOccluded / chunksInFrustum : 0.0,
+                    renderStats.occlusionQueries);
+        ImGui::Text("Chunks Unreachable: %zu (no open path from the camera)", renderStats.chunksUnreachable);
+        ImGui::Text("Alpha Tested Chunks: %zu, Translucent Chunks: %zu (%zu re-sorted)",
+                    renderStats.alphaTestedChunks, renderStats.translucentChunks, renderStats.translucentSorts);
+        ImGui::Text("Draw Calls: %zu (%zu depth pre-pass)%s", renderStats.drawCalls, renderStats.prePassDrawCalls,
+                    Zenith::ChunkDrawBatcher::isMultiDrawSupported() ? "" : " (no multi-draw, GL 3.3)");
+        ImGui::Text("Terrain Overdraw: %.2f fragments shaded per viewport pixel", renderStats.overdraw);
+        ImGui::Text("Terrain Shader: %s", ShaderUtils::getFeatureNames(renderStats.opaqueFeatures).c_str());
+        if (shadowsEnabled && shadowMap.isInitialized()) {
+            ImGui::Text("Shadow Pass: %d of %d cascades (%dx%d) re-rendered, %zu draw calls", shadowMap.getCascadesDue(),
+                        shadowMap.getCascadeCount(), shadowMap.getResolution(), shadowMap.getResolution(), shadowDrawCalls);
+            ImGui::Text("Cascade Splits: %.1f / %.1f / %.1f / %.1f", shadowMap.getSplitDistance(0),
+                        shadowMap.getCascadeCount() > 1 ? shadowMap.getSplitDistance(1) : 0.0f,
+                        shadowMap.getCascadeCount() > 2 ? shadowMap.getSplitDistance(2) : 0.0f,
+                        shadowMap.getCascadeCount() > 3 ? shadowMap.getSplitDistance(3) : 0.0f);
+            ImGui::Text("Sun Steps: %d (every %.2f deg)", shadowSteps, dayNightCycle.getShadowThreshold());
+        } else {
+            ImGui::Text("Shadow Pass: off (shadow code compiled out)");
+        }
+        ImGui::Text("Chunk Mesh Memory: %.2f MB (%s)", renderStats.meshBytes / (1024.0 * 1024.0),
+                    vertexPulling ? "8 bytes per face" : "8 bytes per vertex, 4 per face");
+        const Zenith::ChunkBufferPoolStats poolStats = Zenith::ChunkBufferPool::shared().getStats();
+        ImGui::Text("Chunk Buffers: %zu pages, %.2f MB used, %.2f MB free, %.2f MB awaiting fences",
+                    poolStats.pages, poolStats.usedBytes / (1024.0 * 1024.0), poolStats.freeBytes / (1024.0 * 1024.0),
+                    poolStats.pendingFreeBytes / (1024.0 * 1024.0));
+        ImGui::Text("Fragmentation: %.1f%% (%zu free blocks, largest %.2f MB), %.2f MB moved by defrag",
+                    poolStats.fragmentation * 100.0f, poolStats.freeBlocks, poolStats.largestFreeBlock / (1024.0 * 1024.0),
+                    poolStats.bytesMoved / (1024.0 * 1024.0));
+        ImGui::Text("Tree LODs 1x/2x/4x/8x: %zu/%zu/%zu/%zu", prefabStats.instancesPerLod[0],
+                    prefabStats.instancesPerLod[1], prefabStats.instancesPerLod[2], prefabStats.instancesPerLod[3]);
+
+        const Zenith::ChunkRebuildStats& rebuildStats = terrain->getLastRebuildStats();
+        ImGui::Text("Last Remesh: %zu chunks in %.3f ms, %.2f MB uploaded", rebuildStats.chunksRebuilt,
+                    rebuildStats.milliseconds, rebuildStats.uploadedBytes / (1024.0 * 1024.0));
+        const Zenith::ChunkLightStats& lightStats = terrain->getLastLightStats();
+        ImGui::Text("Last Relight: %zu cells in %.3f ms, %zu passes over %zu chunks", lightStats.cellsChanged,
+                    lightStats.milliseconds, lightStats.passes, lightStats.chunksProcessed);
+        const Zenith::ShaderCacheStats& shaderStats = Zenith::ShaderCache::shared().getStats();
+        ImGui::Text("Shaders: %zu programs, %zu compiled, %zu from stored binaries, %.1f ms", shaderStats.programs,
+                    shaderStats.compiled, shaderStats.binariesLoaded, shaderStats.milliseconds);
+        if (Zenith::ShaderCache::shared().isHotReloadEnabled()) {
+            ImGui::Text("Shader Reloads: %zu, %zu failed (previous program kept)", shaderStats.reloaded,
+                        shaderStats.reloadFailures);
+        }
+        ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+        const Zenith::FramePacingStats& pacingStats = frameClock.getStats();
+        ImGui::Text("Frame Pacing: %.2f ms avg, %.2f ms worst, %.2f ms jitter, %.2f ms limiter wait",
+                    pacingStats.averageMs, pacingStats.worstMs, pacingStats.jitterMs, pacingStats.waitMs);
+        ImGui::Text("Simulation: %d ticks this frame at %.0f Hz, %zu dropped", pacingStats.ticks,
+                    1.0 / frameClock.getTickSeconds(), pacingStats.droppedTicks);
+
+        ImGui::End();
+
+        // Create transformation matrices. The shadow cascades are fitted to the same
+        // camera, so the projection is built from it rather than from its own values
+        Zenith::ShadowCamera viewCamera;
+        viewCamera.view = camera.getViewMatrix();
+        viewCamera.fovY = glm::radians(camera.getZoom());
+        viewCamera.aspect = (float)config.window.width / (float)config.window.height;
+        glm::mat4 view = viewCamera.view;
+        glm::mat4 projection = glm::perspective(viewCamera.fovY, viewCamera.aspect,
+                                                viewCamera.nearPlane, viewCamera.farPlane);
+
+        // Simulation ticks: advance the clock by fixed steps, then hand the renderers
+        // its lighting interpolated between the last two steps
+        for (int tick = 0; tick < ticks; tick++) {
+            previousLighting = dayNightCycle.getLighting();
+            dayNightCycle.advance(static_cast<float>(frameClock.getTickSeconds()));
+            if (dayNightCycle.hasShadowLightDirChanged()) {
+                shadowSteps++;
+            }
+        }
+        const Zenith::SkyLighting lighting = Zenith::DayNightCycle::interpolate(
+            previousLighting, dayNightCycle.getLighting(), frameClock.getAlpha());
+        terrain->setAmbientStrength(lighting.ambientStrength);
+        prefabLibrary.setAmbientStrength(lighting.ambientStrength);
+        Zenith::Lightmap::shared().setSunBrightness(lighting.sunBrightness);
+        skybox.setBlend("sunset", lighting.sunsetBlend);
+        skybox.setTint(lighting.skyTint);
+
+        // Shadow pass: cascades fitted to slices of the view, each reaching back over
+        // the whole world so terrain and trees outside the view still cast
+        shadowDrawCalls = 0;
+        if (shadowsEnabled && (shadowMap.getResolution() != shadowResolution ||
+                               shadowMap.getCascadeCount() != shadowCascades || !shadowMap.isInitialized())) {
+            shadowsEnabled = shadowMap.initialize(shadowResolution, shadowCascades);
+        }
+        if (shadowsEnabled) {
+            glm::vec3 casterMin, casterMax, prefabMin, prefabMax;
+            terrain->getBounds(casterMin, casterMax);
+            if (prefabLibrary.getBounds(prefabMin, prefabMax)) {
+                casterMin = glm::min(casterMin, prefabMin);
+                casterMax = glm::max(casterMax, prefabMax);
+            }
+
+            // The shadow direction only steps once the sun has moved past the
+            // threshold, so the cascades aren't all re-rendered every frame
+            shadowMap.update(dayNightCycle.getShadowLightDir(), viewCamera, casterMin, casterMax);
+
+            int framebufferWidth, framebufferHeight;
+            glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+            for (int cascade = 0; cascade < shadowMap.getCascadeCount(); cascade++) {
+                if (!shadowMap.isCascadeDue(cascade)) {
+                    continue;
+                }
+                const glm::mat4& lightSpaceMatrix = shadowMap.getLightSpaceMatrix(cascade);
+                shadowMap.beginPass(cascade);
+                shadowDrawCalls += terrain->renderDepth(lightSpaceMatrix, camera.getPosition());
+                shadowDrawCalls += prefabLibrary.renderDepth(lightSpaceMatrix, camera.getPosition());
+                shadowMap.endPass(framebufferWidth, framebufferHeight);
+            }
+        }
+        terrain->setShadowMap(shadowsEnabled ? &shadowMap : nullptr);
+        prefabLibrary.setShadowMap(shadowsEnabled ? &shadowMap : nullptr);
+
+        // Clear the screen
+        glm::vec3 clearColor = glm::vec3(0.5f, 0.7f, 0.9f) * lighting.skyTint;
+        if (terrain->getDebugView() == Zenith::ChunkDebugView::OVERDRAW) {
+            clearColor = glm::vec3(0.0f);   // The overdraw view adds up from black
+        }
+        glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // The clear colour stands in until the sky has loaded
+        if (!skybox.getHorizonColor(fog.color)) {
+            fog.color = clearColor;
+        }
+        terrain->setFog(fog);
+        prefabLibrary.setFog(fog);
+
+        // Render the world
+        terrain->render(view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
+        prefabLibrary.render(view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
+
+        // Sky after the opaque passes, it only fills pixels nothing else covered
+        skybox.render(view, projection);
+
+        // Glass and water last, blended over the opaque geometry and the sky
+        terrain->renderTranslucent(view, projection, lighting.lightDir, lighting.lightColor, camera.getPosition());
+
+        // Label the top chunk of every column with the level it was drawn at
+        if (showLodOverlay) {
+            ImDrawList* drawList = ImGui::GetBackgroundDrawList();
+            ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+            glm::mat4 viewProjection = projection * view;
+
+            for (int cz = 0; cz < chunksZ; cz++) {
+                for (int cx = 0; cx < chunksX; cx++) {
+                    for (int cy = chunksY - 1; cy >= 0; cy--) {
+                        const Zenith::Chunk& chunk = terrain->getChunk(cx, cy, cz);
+                        if (chunk.getMesh().isEmpty()) {
+                            continue;
+                        }
+
+                        glm::vec3 center = glm::vec3(chunk.getOrigin()) + glm::vec3(Zenith::CHUNK_SIZE * 0.5f - 0.5f);
+                        glm::vec4 clip = viewProjection * glm::vec4(center, 1.0f);
+                        if (clip.w > 0.0f && std::abs(clip.x) < clip.w && std::abs(clip.y) < clip.w) {
+                            ImVec2 screen((clip.x / clip.w * 0.5f + 0.5f) * displaySize.x,
+                                          (0.5f - clip.y / clip.w * 0.5f) * displaySize.y);
+                            int lod = chunk.getLodLevel();
+                            char label[8];
+                            snprintf(label, sizeof(label), "%dx", 1 << lod);
+                            drawList->AddText(screen, lodColors[lod], label);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Render ImGui
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        // Recycle chunk buffer ranges the GPU is done with, compact when idle
+        Zenith::ChunkBufferPool::shared().endFrame();
+
+        // Hold the frame limit, then swap buffers and poll events
+        frameClock.endFrame();
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // Cleanup ImGui
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+
+    // Clean up
+    prefabLibrary.release();
+    shadowMap.release();
+    skybox.release();
+    Zenith::BlockTextureArray::shared().release();
+    Zenith::Lightmap::shared().release();
+    Zenith::ChunkDrawBatcher::shared().release();
+    Zenith::ChunkBufferPool::shared().release();
+    Zenith::ShaderCache::shared().release();
+    glfwTerminate();
+    return 0;
+}